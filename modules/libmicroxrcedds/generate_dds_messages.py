@@ -5,6 +5,11 @@ Micro XRCE-DDS智能生成脚本
 1. 从ROS 2系统自动获取最新IDL文件
 2. 按原始包结构生成头文件和源文件
 3. 支持消息依赖自动解析
+4. 支持为string/sequence字段设置上限，减小生成结构体的内存占用
+5. 为没有变长字段的消息生成固定的序列化长度，发布时不需要再调用size_of
+6. 可选：结构体和CDR布局一致的消息整体复制序列化，生成结构体布局的静态断言
+7. 基本类型数组/sequence整体调用ucdr_(de)serialize_array_*，不逐个元素处理
+8. 生成_sized序列化函数，size_of时记下字符串长度，序列化时不再调用strlen
 """
 
 import argparse
@@ -17,6 +22,9 @@ import logging
 from collections import defaultdict
 from typing import List, Dict, Tuple, Optional
 
+# 字段上限配置: {(package, msg_type): {field_name: bound}}
+FieldBounds = Dict[Tuple[str, str], Dict[str, int]]
+
 # 配置日志
 logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(levelname)s - %(message)s')
 logger = logging.getLogger('uxr-generator')
@@ -33,9 +41,9 @@ class IdlGenerator:
         self.msg_type = msg_type
         self.idl_path = idl_path
         
-        # 生成的文件名 (小写格式，符合ROS 2命名规范)
-        self.h_name = f"{self.msg_type.lower()}.h"
-        self.c_name = f"{self.msg_type.lower()}.c"
+        # 生成的文件名 (-cs参数下与IDL中的类型名大小写一致)
+        self.h_name = f"{self.msg_type}.h"
+        self.c_name = f"{self.msg_type}.c"
         
         # 生成文件的相对路径
         self.rel_dir = pathlib.Path(self.package) / "msg"
@@ -62,18 +70,20 @@ def find_ros_share_dir(package: str) -> pathlib.Path:
         logger.error(f"Error locating share dir for {package}: {str(e)}")
         raise
 
-def parse_message_list(message_file: pathlib.Path) -> Dict[str, List[str]]:
+def parse_message_list(message_file: pathlib.Path) -> Tuple[Dict[str, List[str]], FieldBounds]:
     """
     解析消息列表文件
-    格式: <package>/<msg_type> (每行一个)
+    格式: <package>/<msg_type> [<field>=<bound> ...] (每行一个)
     示例:
         sensor_msgs/Imu
-        std_msgs/Header
+        std_msgs/Header frame_id=32
+        std_msgs/String data=64
     """
     if not message_file.exists():
         raise FileNotFoundError(f"Message list file not found: {message_file}")
     
     package_msgs = defaultdict(list)
+    field_bounds: FieldBounds = {}
     
     with open(message_file, 'r') as f:
         for line in f:
@@ -87,17 +97,103 @@ def parse_message_list(message_file: pathlib.Path) -> Dict[str, List[str]]:
                 logger.warning(f"Invalid message format: {line}. Skipping.")
                 continue
             
-            package, msg_type = line.split('/', 1)
+            name, *options = line.split()
+            package, msg_type = name.split('/', 1)
             package = package.strip()
             msg_type = msg_type.strip()
             
             if not package or not msg_type:
                 logger.warning(f"Invalid message format: {line}. Skipping.")
                 continue
+
+            bounds = {}
+            for option in options:
+                field, _, bound = option.partition('=')
+                if not field or not bound.isdigit() or int(bound) == 0:
+                    logger.warning(f"Invalid field bound '{option}' for {name}. Skipping.")
+                    continue
+                bounds[field] = int(bound)
+            if bounds:
+                field_bounds[(package, msg_type)] = bounds
                 
             package_msgs[package].append(msg_type)
     
-    return package_msgs
+    return package_msgs, field_bounds
+
+# microxrceddsgen把无上限的string展开成char[255]，无上限的sequence展开成固定容量的数组，
+# 在IDL中写明上限后生成的结构体只占用需要的空间
+_STRING_MEMBER = re.compile(r'^(\s*)string\s+(\w+)\s*;', re.MULTILINE)
+_SEQUENCE_MEMBER = re.compile(r'^(\s*)sequence<([^,<>]+)>\s+(\w+)\s*;', re.MULTILINE)
+
+def apply_field_bounds(
+    idl_text: str,
+    bounds: Dict[str, int],
+    string_bound: Optional[int] = None,
+    sequence_bound: Optional[int] = None
+) -> Tuple[str, List[str]]:
+    """
+    为IDL中无上限的string/sequence成员加上上限
+    :param bounds: 按字段名指定的上限，优先于默认值
+    :param string_bound: 其余string成员的默认上限，None表示保持不变
+    :param sequence_bound: 其余sequence成员的默认上限，None表示保持不变
+    :return: 修改后的IDL和被修改的字段列表
+    """
+    changed = []
+
+    def bound_string(m: re.Match) -> str:
+        bound = bounds.get(m.group(2), string_bound)
+        if bound is None:
+            return m.group(0)
+        changed.append(f"{m.group(2)}<{bound}>")
+        return f"{m.group(1)}string<{bound}> {m.group(2)};"
+
+    def bound_sequence(m: re.Match) -> str:
+        bound = bounds.get(m.group(3), sequence_bound)
+        if bound is None:
+            return m.group(0)
+        changed.append(f"{m.group(3)}<{bound}>")
+        return f"{m.group(1)}sequence<{m.group(2).strip()}, {bound}> {m.group(3)};"
+
+    idl_text = _STRING_MEMBER.sub(bound_string, idl_text)
+    idl_text = _SEQUENCE_MEMBER.sub(bound_sequence, idl_text)
+    return idl_text, changed
+
+def stage_bounded_idls(
+    idl_generators: List[IdlGenerator],
+    field_bounds: FieldBounds,
+    staging_dir: pathlib.Path,
+    string_bound: Optional[int] = None,
+    sequence_bound: Optional[int] = None
+) -> bool:
+    """
+    把需要加上限的IDL复制到staging_dir/<package>/msg下并改写，生成器改为使用改写后的文件
+    :return: 是否有IDL被改写(需要把staging_dir加入包含路径)
+    """
+    staged = False
+
+    for gen in idl_generators:
+        bounds = field_bounds.get((gen.package, gen.msg_type), {})
+        if not bounds and string_bound is None and sequence_bound is None:
+            continue
+
+        idl_text, changed = apply_field_bounds(
+            gen.idl_path.read_text(), bounds, string_bound, sequence_bound)
+
+        unknown = set(bounds) - {c.split('<', 1)[0] for c in changed}
+        if unknown:
+            logger.warning(f"{gen.package}/{gen.msg_type}: no unbounded string/sequence field named "
+                           f"{', '.join(sorted(unknown))}")
+        if not changed:
+            continue
+
+        staged_path = staging_dir / gen.package / "msg" / gen.idl_path.name
+        staged_path.parent.mkdir(parents=True, exist_ok=True)
+        staged_path.write_text(idl_text)
+        gen.idl_path = staged_path
+        staged = True
+        logger.info(f"Bounded {gen.package}/{gen.msg_type}: {', '.join(changed)}")
+
+    return staged
 
 def locate_idl_files(package_msgs: Dict[str, List[str]]) -> List[IdlGenerator]:
     """定位所有IDL文件"""
@@ -131,11 +227,407 @@ def locate_idl_files(package_msgs: Dict[str, List[str]]) -> List[IdlGenerator]:
     
     return idl_generators
 
+# CDR中基本类型的长度，同时也是它的对齐要求
+_PRIMITIVE_SIZES = {
+    'boolean': 1, 'octet': 1, 'char': 1, 'int8': 1, 'uint8': 1,
+    'short': 2, 'int16': 2, 'uint16': 2,
+    'long': 4, 'int32': 4, 'uint32': 4, 'float': 4,
+    'int64': 8, 'uint64': 8, 'double': 8,
+}
+_ANNOTATION = re.compile(r'@\w+(?:\s*\((?:[^()"]|"(?:\\.|[^"\\])*")*\))?')
+_COMMENT = re.compile(r'//[^\n]*|/\*.*?\*/', re.DOTALL)
+_TYPEDEF = re.compile(r'typedef\s+([\w:]+)\s+(\w+)\s*\[\s*(\d+)\s*\]\s*;')
+_STRUCT = re.compile(r'struct\s+\w+\s*\{(.*?)\};', re.DOTALL)
+_MEMBER = re.compile(r'([\w:]+(?:<[^;]*>)?)\s+(\w+)\s*(?:\[\s*(\d+)\s*\])?\s*;')
+
+class FixedSizeResolver:
+    """
+    计算消息在CDR中的序列化长度，只有基本类型、定长数组和定长嵌套类型的消息才有固定长度
+    嵌套类型的IDL按照 已生成的IDL -> ROS 2 share目录 的顺序查找，找不到的按变长处理
+    """
+    def __init__(self, idl_generators: List[IdlGenerator]):
+        self.idl_paths = {(gen.package, gen.msg_type): gen.idl_path for gen in idl_generators}
+        self.members: Dict[Tuple[str, str], Optional[List[Tuple[str, str, int]]]] = {}
+        self.layouts: Dict[Tuple[str, str], Optional[List[int]]] = {}
+        self.natural: Dict[Tuple[str, str], Optional[NaturalLayout]] = {}
+
+    def _idl_path(self, package: str, msg_type: str) -> Optional[pathlib.Path]:
+        path = self.idl_paths.get((package, msg_type))
+        if path is None:
+            try:
+                path = find_ros_share_dir(package) / "msg" / f"{msg_type}.idl"
+            except Exception:
+                return None
+        return path if path.exists() else None
+
+    def _members(self, package: str, msg_type: str) -> Optional[List[Tuple[str, str, int]]]:
+        """结构体成员 (名称, 类型, 元素个数)，typedef已展开，找不到IDL返回None"""
+        key = (package, msg_type)
+        if key in self.members:
+            return self.members[key]
+        self.members[key] = None
+
+        idl_path = self._idl_path(package, msg_type)
+        if idl_path is None:
+            return None
+
+        idl_text = _COMMENT.sub('', _ANNOTATION.sub('', idl_path.read_text()))
+        struct = _STRUCT.search(idl_text)
+        if not struct:
+            return None
+        typedefs = {m.group(2): (m.group(1), int(m.group(3))) for m in _TYPEDEF.finditer(idl_text)}
+
+        members = []
+        for m in _MEMBER.finditer(struct.group(1)):
+            member_type, count = m.group(1), int(m.group(3) or 1)
+            if member_type in typedefs:
+                member_type, typedef_count = typedefs[member_type]
+                count *= typedef_count
+            members.append((m.group(2), member_type, count))
+
+        self.members[key] = members
+        return members
+
+    @staticmethod
+    def _nested(member_type: str) -> Optional[Tuple[str, str]]:
+        """<package>::msg::<type> 形式的嵌套消息类型"""
+        parts = member_type.split('::')
+        return (parts[0], parts[-1]) if len(parts) == 3 and parts[1] == 'msg' else None
+
+    def _layout(self, package: str, msg_type: str) -> Optional[List[int]]:
+        """按序列化顺序展开的基本类型长度列表，变长消息返回None"""
+        key = (package, msg_type)
+        if key in self.layouts:
+            return self.layouts[key]
+        self.layouts[key] = None  # 防止循环引用
+
+        members = self._members(package, msg_type)
+        if members is None:
+            return None
+
+        layout: List[int] = []
+        for _, member_type, count in members:
+            if member_type in _PRIMITIVE_SIZES:
+                layout.extend([_PRIMITIVE_SIZES[member_type]] * count)
+                continue
+
+            nested = self._nested(member_type)
+            nested_layout = self._layout(*nested) if nested else None
+            if nested_layout is None:
+                return None  # string/sequence或无法解析的类型
+            layout.extend(nested_layout * count)
+
+        self.layouts[key] = layout
+        return layout
+
+    def fixed_size(self, package: str, msg_type: str) -> int:
+        """从偏移0开始序列化的长度，变长消息返回0"""
+        layout = self._layout(package, msg_type)
+        if not layout:
+            return 0
+        size = 0
+        for item in layout:
+            size += (-size) % item + item
+        return size
+
+    def natural_layout(self, package: str, msg_type: str) -> Optional['NaturalLayout']:
+        """
+        定长消息按C自然对齐(对齐要求等于基本类型长度，ARM EABI和x86_64)排布的结构体布局，
+        逐个成员和CDR布局比较，变长消息返回None
+        """
+        key = (package, msg_type)
+        if key in self.natural:
+            return self.natural[key]
+        self.natural[key] = None
+
+        members = self._members(package, msg_type)
+        if members is None or not self._layout(package, msg_type):
+            return None
+
+        offsets: List[Tuple[str, int, Optional[str]]] = []
+        offset, align, first = 0, 1, 0
+        wire = True
+        for name, member_type, count in members:
+            if member_type in _PRIMITIVE_SIZES:
+                size = _PRIMITIVE_SIZES[member_type]
+                c_offset = offset + (-offset) % size
+                offsets.append((name, c_offset, None))
+                offset = c_offset + size * count
+                align = max(align, size)
+                first = first or size
+                wire &= member_type != 'boolean'  # memcpy不会把非0/1的值规整成bool
+                continue
+
+            nested_key = self._nested(member_type)
+            nested = self.natural_layout(*nested_key)
+            if nested is None:
+                return None
+            c_offset = offset + (-offset) % nested.align
+            cdr_offset = offset + (-offset) % nested.first
+            offsets.append((name, c_offset, f"{nested_key[0]}_msg_{nested_key[1]}"))
+            # 嵌套结构体的起点和结尾的填充都要和CDR一致
+            wire &= nested.wire and c_offset == cdr_offset and nested.size == nested.fixed_size
+            offset = c_offset + nested.size * count
+            align = max(align, nested.align)
+            first = first or nested.first
+
+        size = offset + (-offset) % align
+        layout = NaturalLayout(offsets, size, align, first, self.fixed_size(package, msg_type), wire)
+        self.natural[key] = layout
+        return layout
+
+class NaturalLayout:
+    """定长消息的C结构体布局"""
+    def __init__(self, offsets: List[Tuple[str, int, Optional[str]]], size: int, align: int,
+                 first: int, fixed_size: int, wire: bool):
+        """
+        :param offsets: 顶层成员 (名称, 偏移, 嵌套消息的C类型名或None)
+        :param size: sizeof
+        :param align: alignof，也是CDR中整个消息需要的对齐
+        :param first: 第一个基本类型成员的长度，CDR中消息起点的对齐
+        :param fixed_size: CDR序列化长度
+        :param wire: 结构体内存和CDR小端序列化的结果逐字节一致
+        """
+        self.offsets = offsets
+        self.size = size
+        self.align = align
+        self.first = first
+        self.fixed_size = fixed_size
+        self.wire = wire
+
+def emit_fixed_size(h_file: pathlib.Path, package: str, msg_type: str, fixed_size: int):
+    """在生成的头文件中size_of函数声明的后面加上固定长度宏"""
+    text = h_file.read_text()
+    macro = f"{package}_msg_{msg_type}_FIXED_SIZE"
+    if macro in text:
+        return
+    declaration = re.search(rf'^uint32_t {package}_msg_{msg_type}_size_of_topic\(.*\);$', text, re.MULTILINE)
+    if not declaration:
+        logger.warning(f"size_of declaration not found in {h_file}, {macro} not emitted")
+        return
+    text = (text[:declaration.end()] +
+            "\n\n// CDR serialized size when the type has no variable-length member, 0 otherwise" +
+            f"\n#define {macro} {fixed_size}u" +
+            text[declaration.end():])
+    h_file.write_text(text)
+
+def emit_wire_layout(h_file: pathlib.Path, c_file: pathlib.Path, package: str, msg_type: str,
+                     layout: NaturalLayout):
+    """
+    结构体和CDR布局一致的消息：头文件中加上由编译器检查的布局宏，
+    序列化/反序列化在流按消息对齐且字节序相同时整体复制，否则仍逐个成员处理
+    """
+    name = f"{package}_msg_{msg_type}"
+    macro = f"{name}_WIRE_LAYOUT"
+    text = h_file.read_text()
+    if macro not in text:
+        fixed = re.search(rf'^#define {name}_FIXED_SIZE .*$', text, re.MULTILINE)
+        includes = re.search(r'^#include <stdbool.h>$', text, re.MULTILINE)
+        if not fixed or not includes:
+            logger.warning(f"FIXED_SIZE macro or includes not found in {h_file}, {macro} not emitted")
+            return
+        # 编译器按目标ABI算出的偏移和CDR一致时为真(比如i386上double只按4字节对齐时为假)
+        checks = [f"offsetof({name}, {member}) == {offset}" for member, offset, _ in layout.offsets]
+        checks += [f"{nested}_WIRE_LAYOUT" for _, _, nested in layout.offsets if nested]
+        condition = " && \\\n    ".join(checks)
+        text = (text[:fixed.end()] +
+                "\n\n// Struct memory equals the little endian CDR encoding on this ABI" +
+                f"\n#define {macro} ({condition})" +
+                f"\n// CDR alignment the whole sample needs for a single copy" +
+                f"\n#define {name}_WIRE_ALIGNMENT {layout.align}u" +
+                text[fixed.end():])
+        text = text[:includes.end()] + "\n#include <stddef.h>" + text[includes.end():]
+        h_file.write_text(text)
+
+    text = c_file.read_text()
+    if macro in text:
+        return
+    for direction, buffer, cast in (("serialize", "writer", "const uint8_t*"), ("deserialize", "reader", "uint8_t*")):
+        body = re.search(rf'^bool {name}_{direction}_topic\(.*\)\n\{{\n\s*bool success = true;\n', text,
+                         re.MULTILINE)
+        if not body:
+            logger.warning(f"{direction}_topic not found in {c_file}, wire layout copy not emitted")
+            return
+        fast_path = (
+            "\n    // One copy when the stream is aligned for the whole sample\n"
+            f"    if ({macro} && {buffer}->endianness == UCDR_MACHINE_ENDIANNESS &&\n"
+            f"        ucdr_buffer_alignment({buffer}, {name}_WIRE_ALIGNMENT) == 0)\n"
+            "    {\n"
+            f"        return ucdr_{direction}_array_uint8_t({buffer}, ({cast})topic, {name}_FIXED_SIZE) && !{buffer}->error;\n"
+            "    }\n")
+        text = text[:body.end()] + fast_path + text[body.end():]
+    c_file.write_text(text)
+
+def emit_layout_asserts(c_file: pathlib.Path, package: str, msg_type: str, layout: NaturalLayout,
+                        wire_layout: bool):
+    """在生成的源文件中检查结构体的sizeof/alignof，整体复制序列化的消息同时检查布局宏"""
+    name = f"{package}_msg_{msg_type}"
+    text = c_file.read_text()
+    if f"_Static_assert(sizeof({name})" in text:
+        return
+    includes = re.search(r'^#include <string.h>$', text, re.MULTILINE)
+    if not includes:
+        logger.warning(f"includes not found in {c_file}, layout asserts not emitted")
+        return
+    asserts = (f"\n\n_Static_assert(sizeof({name}) == {layout.size}u, \"{name} size changed\");" +
+               f"\n_Static_assert(_Alignof({name}) == {layout.align}u, \"{name} alignment changed\");")
+    if layout.wire and wire_layout:
+        asserts += (f"\n_Static_assert({name}_WIRE_LAYOUT, "
+                    f"\"{name} struct layout differs from its CDR layout on this ABI\");")
+    text = text[:includes.end()] + asserts + text[includes.end():]
+    c_file.write_text(text)
+
+# 逐个元素处理基本类型数组/sequence的循环，循环体可以不带大括号
+_LOOP_HEAD = (r'(?P<indent>[ \t]*)for\s*\(\s*(?:size_t|uint32_t|int32_t|int|unsigned(?:\s+int)?)\s+(?P<i>\w+)\s*=\s*0\s*;'
+              r'\s*(?P=i)\s*<\s*(?P<count>[^;]+?)\s*;\s*(?:\+\+\s*(?P=i)|(?P=i)\s*\+\+)\s*\)\s*(?P<open>\{)?\s*')
+_LOOP_TAIL = r'(?(open)\s*\})'
+_CODEC_LOOP = re.compile(
+    _LOOP_HEAD +
+    r'success\s*&=\s*ucdr_(?P<dir>serialize|deserialize)_(?P<type>(?!array_|sequence_)\w+)'
+    r'\(\s*(?P<buf>\w+)\s*,\s*&?\s*topic->(?P<field>[\w.]+)\[\s*(?P=i)\s*\]\s*\)\s*;' +
+    _LOOP_TAIL)
+_SIZE_LOOP = re.compile(
+    _LOOP_HEAD +
+    r'size\s*\+=\s*ucdr_alignment\(\s*size\s*,\s*(?P<align>\d+)\s*\)\s*\+\s*(?P<size>\d+)\s*;' +
+    _LOOP_TAIL)
+_ELEMENT_CALL = re.compile(r'ucdr_(?:serialize|deserialize)_(?!array_|sequence_)\w+\([^;]*\[\s*\w+\s*\]\s*\)')
+
+def _guard_empty(indent: str, count: str, statement: str) -> str:
+    """CDR中空数组前没有对齐填充，元素个数不是常量时只在非空时调用，编码和逐个元素处理完全一致"""
+    if count.isdigit():
+        return f"{indent}{statement}"
+    return f"{indent}if (({count}) > 0)\n{indent}{{\n{indent}    {statement}\n{indent}}}"
+
+def emit_bulk_arrays(c_file: pathlib.Path) -> int:
+    """
+    把逐个元素的基本类型数组/sequence循环改写成一次ucdr_(de)serialize_array_*调用，
+    size_of只在第一个元素前对齐。字节序和流相同时array函数直接复制，不同时才逐个交换字节。
+    :return: 改写的循环个数
+    """
+    text = c_file.read_text()
+    rewritten = 0
+
+    def codec(m: re.Match) -> str:
+        nonlocal rewritten
+        rewritten += 1
+        indent, count = m.group('indent'), m.group('count')
+        call = (f"success &= ucdr_{m.group('dir')}_array_{m.group('type')}"
+                f"({m.group('buf')}, topic->{m.group('field')}, {count});")
+        return _guard_empty(indent, count, call)
+
+    def size_of(m: re.Match) -> str:
+        nonlocal rewritten
+        if m.group('align') != m.group('size'):
+            return m.group(0)
+        rewritten += 1
+        indent, count, size = m.group('indent'), m.group('count'), m.group('size')
+        return _guard_empty(indent, count, f"size += ucdr_alignment(size, {size}) + ({count}) * {size};")
+
+    text = _CODEC_LOOP.sub(codec, text)
+    text = _SIZE_LOOP.sub(size_of, text)
+
+    left = len(_ELEMENT_CALL.findall(text))
+    if left:
+        logger.warning(f"{c_file}: {left} element-wise array call(s) left, not a plain loop over a primitive array")
+    if rewritten:
+        c_file.write_text(text)
+    return rewritten
+
+# size_of中的字符串长度和嵌套消息，序列化中与之一一对应的调用
+_SIZE_STRING = re.compile(r'\(uint32_t\)strlen\(topic->(?P<field>[\w.]+)\)')
+_SIZE_NESTED = re.compile(r'(?P<type>\w+)_size_of_topic\(&topic->(?P<field>[\w.]+), size\)')
+_SER_STRING = re.compile(r'ucdr_serialize_string\((?P<buf>\w+), topic->(?P<field>[\w.]+)\)')
+_SER_NESTED = re.compile(r'(?P<type>\w+)_serialize_topic\((?P<buf>\w+), &topic->(?P<field>[\w.]+)\)')
+
+def _function_body(text: str, signature: str) -> Optional[re.Match]:
+    return re.search(rf'^{signature}\n\{{\n(?P<body>.*?)^\}}$', text, re.MULTILINE | re.DOTALL)
+
+def _sized_items(body: str, string: re.Pattern, nested: re.Pattern) -> List[Tuple[int, int, str, re.Match]]:
+    items = [(m.start(), m.end(), 'string', m) for m in string.finditer(body)]
+    items += [(m.start(), m.end(), 'nested', m) for m in nested.finditer(body)]
+    return sorted(items, key=lambda item: item[0])
+
+def emit_sized_strings(h_file: pathlib.Path, c_file: pathlib.Path, package: str, msg_type: str):
+    """
+    生成<type>_size_of_topic_sized/<type>_serialize_topic_sized：
+    size_of时把每个字符串的strlen记在lengths中，序列化时直接按记下的长度写入，
+    发布一个样本只需要一次strlen，编码结果和ucdr_serialize_string完全相同。
+    嵌套消息依次使用lengths后面的位置，数组中的字符串和嵌套消息仍然在两边各算一次。
+    """
+    name = f"{package}_msg_{msg_type}"
+    macro = f"{name}_SIZED_LENGTHS"
+    h_text = h_file.read_text()
+    c_text = c_file.read_text()
+    if macro in h_text:
+        return
+
+    size_of = _function_body(c_text, rf'uint32_t {name}_size_of_topic\(const {name}\* topic, uint32_t size\)')
+    serialize = _function_body(c_text, rf'bool {name}_serialize_topic\(ucdrBuffer\* writer, const {name}\* topic\)')
+    fixed = re.search(rf'^#define {name}_FIXED_SIZE .*$', h_text, re.MULTILINE)
+    if not size_of or not serialize or not fixed:
+        logger.warning(f"size_of/serialize_topic not found for {name}, sized functions not emitted")
+        return
+
+    size_items = _sized_items(size_of.group('body'), _SIZE_STRING, _SIZE_NESTED)
+    ser_items = _sized_items(serialize.group('body'), _SER_STRING, _SER_NESTED)
+    plan = [(kind, m.group('field'), m.groupdict().get('type')) for _, _, kind, m in size_items]
+    matched = plan == [(kind, m.group('field'), m.groupdict().get('type')) for _, _, kind, m in ser_items]
+    # 数组元素等其他形式的strlen/嵌套调用没有固定的位置，只能退回普通函数
+    leftover = (size_of.group('body').count('strlen(') != sum(kind == 'string' for kind, _, _ in plan) or
+                len(re.findall(r'_size_of_topic\(', size_of.group('body'))) != sum(kind == 'nested' for kind, _, _ in plan))
+    if plan and (not matched or leftover):
+        logger.warning(f"{name}: string members not in a fixed order, sized functions fall back to strlen")
+        plan = []
+
+    offset = []
+    size_body, ser_body = size_of.group('body'), serialize.group('body')
+    size_out, ser_out, size_pos, ser_pos = [], [], 0, 0
+    for (kind, field, nested), size_item, ser_item in zip(plan, size_items, ser_items):
+        at = " + ".join(offset) if offset else "0"
+        size_m, ser_m = size_item[3], ser_item[3]
+        if kind == 'string':
+            size_call = f"(lengths[{at}] = (uint32_t)strlen(topic->{field}))"
+            ser_call = f"ucdr_serialize_sequence_char({ser_m.group('buf')}, topic->{field}, lengths[{at}] + 1)"
+            offset.append("1u")
+        else:
+            size_call = f"{nested}_size_of_topic_sized(&topic->{field}, size, lengths + {at})"
+            ser_call = f"{nested}_serialize_topic_sized({ser_m.group('buf')}, &topic->{field}, lengths + {at})"
+            offset.append(f"{nested}_SIZED_LENGTHS")
+        size_out += [size_body[size_pos:size_m.start()], size_call]
+        ser_out += [ser_body[ser_pos:ser_m.start()], ser_call]
+        size_pos, ser_pos = size_m.end(), ser_m.end()
+
+    if plan:
+        lengths = " + ".join(offset)
+        size_sized = "".join(size_out) + size_body[size_pos:]
+        ser_sized = "".join(ser_out) + ser_body[ser_pos:]
+    else:
+        lengths = "0u"
+        size_sized = "    (void)lengths;\n    return " + f"{name}_size_of_topic(topic, size);\n"
+        ser_sized = "    (void)lengths;\n    return " + f"{name}_serialize_topic(writer, topic);\n"
+
+    c_text += (f"\nuint32_t {name}_size_of_topic_sized(const {name}* topic, uint32_t size, uint32_t* lengths)\n"
+               f"{{\n{size_sized}}}\n"
+               f"\nbool {name}_serialize_topic_sized(ucdrBuffer* writer, const {name}* topic, const uint32_t* lengths)\n"
+               f"{{\n{ser_sized}}}\n")
+    c_file.write_text(c_text)
+
+    h_text = (h_text[:fixed.end()] +
+              "\n\n// String lengths size_of_topic_sized records for serialize_topic_sized, which then" +
+              "\n// writes the sample without another strlen" +
+              f"\n#define {macro} ({lengths})" +
+              f"\nuint32_t {name}_size_of_topic_sized(const {name}* topic, uint32_t size, uint32_t* lengths);" +
+              f"\nbool {name}_serialize_topic_sized(struct ucdrBuffer* writer, const {name}* topic, const uint32_t* lengths);" +
+              h_text[fixed.end():])
+    h_file.write_text(h_text)
+
 def generate_uxr_code(
     idl_generators: List[IdlGenerator],
     output_dir: pathlib.Path,
     include_paths: List[pathlib.Path] = None,
     replace: bool = True,
+    wire_layout: bool = False,
+    layout_asserts: bool = False,
     # container_prealloc_size: int = 4
 ):
     """生成Micro XRCE-DDS代码"""
@@ -149,6 +641,7 @@ def generate_uxr_code(
     
     # 收集所有生成的源文件路径
     generated_files = []
+    size_resolver = FixedSizeResolver(idl_generators)
     
     for package, generators in package_groups.items():
         logger.info(f"Processing package: {package}")
@@ -193,6 +686,17 @@ def generate_uxr_code(
                 c_file = pkg_output_dir / gen.c_name
                 
                 if h_file.exists() and c_file.exists():
+                    emit_fixed_size(h_file, gen.package, gen.msg_type,
+                                    size_resolver.fixed_size(gen.package, gen.msg_type))
+                    bulk = emit_bulk_arrays(c_file)
+                    if bulk:
+                        logger.info(f"{gen.package}/{gen.msg_type}: {bulk} array loop(s) turned into bulk calls")
+                    emit_sized_strings(h_file, c_file, gen.package, gen.msg_type)
+                    layout = size_resolver.natural_layout(gen.package, gen.msg_type)
+                    if layout and layout.wire and wire_layout:
+                        emit_wire_layout(h_file, c_file, gen.package, gen.msg_type, layout)
+                    if layout and layout_asserts:
+                        emit_layout_asserts(c_file, gen.package, gen.msg_type, layout, wire_layout)
                     logger.info(f"Generated: {h_file.relative_to(output_dir)}")
                     logger.info(f"Generated: {c_file.relative_to(output_dir)}")
                     generated_files.append(h_file)
@@ -234,6 +738,28 @@ def main():
         default=[],
         help="额外的包含目录"
     )
+    parser.add_argument(
+        '--string-bound',
+        type=int,
+        default=None,
+        help="未在消息列表中指定上限的string字段的默认上限(microxrceddsgen默认为255)"
+    )
+    parser.add_argument(
+        '--sequence-bound',
+        type=int,
+        default=None,
+        help="未在消息列表中指定上限的sequence字段的默认上限"
+    )
+    parser.add_argument(
+        '--wire-layout',
+        action='store_true',
+        help="结构体和CDR布局一致的定长消息在序列化/反序列化时整体复制"
+    )
+    parser.add_argument(
+        '--layout-asserts',
+        action='store_true',
+        help="为定长消息生成sizeof/alignof和布局的静态断言，目标ABI的布局和预期不同时编译失败"
+    )
     parser.add_argument(
         '--no-replace',
         action='store_false',
@@ -260,7 +786,7 @@ def main():
     # 1. 解析消息列表
     logger.info(f"Parsing message list: {args.message_file}")
     try:
-        package_msgs = parse_message_list(args.message_file)
+        package_msgs, field_bounds = parse_message_list(args.message_file)
     except Exception as e:
         logger.error(f"Failed to parse message list: {str(e)}")
         sys.exit(1)
@@ -280,14 +806,23 @@ def main():
         sys.exit(1)
     
     logger.info(f"Found {len(idl_generators)} IDL files for generation")
+
+    # 改写需要加上限的IDL，改写后的目录优先于ROS 2的share目录被包含
+    staging_dir = args.output / ".bounded_idl"
+    include_paths = list(args.include)
+    if stage_bounded_idls(idl_generators, field_bounds, staging_dir,
+                          args.string_bound, args.sequence_bound):
+        include_paths.insert(0, staging_dir)
     
     # 3. 生成代码
     logger.info(f"Generating code to: {args.output}")
     generated_files = generate_uxr_code(
         idl_generators,
         args.output,
-        include_paths=args.include,
+        include_paths=include_paths,
         replace=args.replace,
+        wire_layout=args.wire_layout,
+        layout_asserts=args.layout_asserts,
         # container_prealloc_size=args.container_prealloc_size
     )
     
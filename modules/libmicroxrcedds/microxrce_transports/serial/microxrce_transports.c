@@ -0,0 +1,261 @@
+#include <uxr/client/transport.h>
+
+#include <zephyr/kernel.h>
+
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "microxrce_transports.h"
+
+#include <zephyr/device.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/linker/section_tags.h>
+#include <zephyr/sys/ring_buffer.h>
+
+LOG_MODULE_DECLARE(DDS, LOG_LEVEL_INF);
+
+#define RING_BUF_SIZE CONFIG_MICROXRCEDDSCLIENT_SERIAL_RINGBUF_SIZE
+#define RX_DMA_BUF_SIZE CONFIG_MICROXRCEDDSCLIENT_SERIAL_RX_BUF_SIZE
+#define RX_TIMEOUT_US CONFIG_MICROXRCEDDSCLIENT_SERIAL_RX_TIMEOUT_US
+/* Upper bound for the driver to report an aborted transfer */
+#define TX_ABORT_TIMEOUT_MS 100
+
+/* The DMA engine reads and writes these directly, keep them out of the
+ * data cache (no-op unless CONFIG_NOCACHE_MEMORY is enabled) */
+static uint8_t uart_rx_dma_buffer[2][RX_DMA_BUF_SIZE] __nocache __aligned(32);
+static uint8_t uart_out_buffer[RING_BUF_SIZE] __nocache __aligned(32);
+static uint8_t uart_in_buffer[RING_BUF_SIZE];
+
+static struct ring_buf out_ringbuf, in_ringbuf;
+
+/* Given by the UART callback whenever new bytes land in in_ringbuf */
+static K_SEM_DEFINE(in_ringbuf_sem, 0, 1);
+
+/* Set while a uart_tx() transfer owns the claimed out_ringbuf region */
+static atomic_t tx_busy;
+/* Cleared before closing so UART_RX_DISABLED doesn't restart reception */
+static atomic_t rx_active;
+/* Cleared before closing so no transfer is started or finished on a ring
+ * that zephyr_transport_open() is about to reset */
+static atomic_t tx_active;
+/* DMA buffer handed to the driver on the next UART_RX_BUF_REQUEST */
+static uint8_t rx_next_buffer;
+
+/* ISR timing, written by the UART callback only */
+static zephyr_transport_stats_t transport_stats;
+/* Bumped from the UART callback and the writing threads */
+static atomic_t tx_full;
+static atomic_t rx_dropped;
+
+static const struct device *xrce_uart_device(void){
+#if DT_HAS_CHOSEN(mirac_xrce_dds_uart)
+    return DEVICE_DT_GET(DT_CHOSEN(mirac_xrce_dds_uart));
+#else
+    return device_get_binding(CONFIG_MICROXRCEDDSCLIENT_SERIAL_PORT);
+#endif
+}
+
+static int uart_rx_start(const struct device *dev){
+    rx_next_buffer = 1;
+    return uart_rx_enable(dev, uart_rx_dma_buffer[0], RX_DMA_BUF_SIZE, RX_TIMEOUT_US);
+}
+
+/* Start a DMA transfer of the next contiguous out_ringbuf region, unless
+ * one is already running. Called from both thread and callback context. */
+static void uart_tx_kick(const struct device *dev){
+    uint8_t *data;
+    uint32_t len;
+
+    if (!atomic_get(&tx_active) || !atomic_cas(&tx_busy, 0, 1)) {
+        return;
+    }
+
+    len = ring_buf_get_claim(&out_ringbuf, &data, RING_BUF_SIZE);
+    if (len == 0) {
+        atomic_set(&tx_busy, 0);
+        return;
+    }
+
+    if (uart_tx(dev, data, len, SYS_FOREVER_US) != 0) {
+        ring_buf_get_finish(&out_ringbuf, 0);
+        atomic_set(&tx_busy, 0);
+    }
+}
+
+static void uart_async_callback(const struct device *dev, struct uart_event *evt, void *user_data){
+    ARG_UNUSED(user_data);
+    const uint32_t isr_start = k_cycle_get_32();
+
+    switch (evt->type) {
+    case UART_TX_DONE:
+    case UART_TX_ABORTED:
+        /* Release what was sent, an aborted remainder stays queued. After
+         * close the ring is left alone, open resets it. */
+        if (atomic_get(&tx_active)) {
+            ring_buf_get_finish(&out_ringbuf, evt->data.tx.len);
+        }
+        atomic_set(&tx_busy, 0);
+        uart_tx_kick(dev);
+        break;
+
+    case UART_RX_RDY: {
+        uint32_t put = ring_buf_put(&in_ringbuf, evt->data.rx.buf + evt->data.rx.offset, evt->data.rx.len);
+
+        /* No logging in the callback, the drop shows up in the stats */
+        atomic_add(&rx_dropped, (atomic_val_t)(evt->data.rx.len - put));
+        if (put > 0) {
+            k_sem_give(&in_ringbuf_sem);
+        }
+        break;
+    }
+
+    case UART_RX_BUF_REQUEST:
+        /* Double buffering, DMA keeps running into the other buffer */
+        uart_rx_buf_rsp(dev, uart_rx_dma_buffer[rx_next_buffer], RX_DMA_BUF_SIZE);
+        rx_next_buffer ^= 1;
+        break;
+
+    case UART_RX_STOPPED:
+        LOG_ERR("UART RX stopped, reason %d.", evt->data.rx_stop.reason);
+        break;
+
+    case UART_RX_DISABLED:
+        /* Restart after a line error unless the transport is closing */
+        if (atomic_get(&rx_active)) {
+            uart_rx_start(dev);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    const uint32_t isr_cycles = k_cycle_get_32() - isr_start;
+    transport_stats.isr_count++;
+    transport_stats.isr_cycles_total += isr_cycles;
+    transport_stats.isr_cycles_max = MAX(transport_stats.isr_cycles_max, isr_cycles);
+}
+
+void zephyr_transport_get_stats(zephyr_transport_stats_t * stats){
+    *stats = transport_stats;
+    stats->tx_full = (uint32_t)atomic_get(&tx_full);
+    stats->rx_dropped = (uint32_t)atomic_get(&rx_dropped);
+}
+
+bool zephyr_transport_open(struct uxrCustomTransport * transport){
+    zephyr_transport_params_t * params = (zephyr_transport_params_t*) transport->args;
+
+    int ret;
+
+    params->uart_dev = xrce_uart_device();
+    if (!params->uart_dev || !device_is_ready(params->uart_dev)) {
+        LOG_ERR("UART device not found.");
+        return false;
+    }
+
+#if CONFIG_MICROXRCEDDSCLIENT_SERIAL_BAUDRATE > 0
+    struct uart_config cfg;
+
+    ret = uart_config_get(params->uart_dev, &cfg);
+    if (ret == 0) {
+        cfg.baudrate = CONFIG_MICROXRCEDDSCLIENT_SERIAL_BAUDRATE;
+        ret = uart_configure(params->uart_dev, &cfg);
+    }
+    if (ret) {
+        LOG_ERR("Failed to set baudrate, ret code %d.", ret);
+        return false;
+    }
+#endif
+
+    /* A transfer aborted by the last close may still be reading the old
+     * ring, wait for its UART_TX_ABORTED before resetting it */
+    for (int waited_ms = 0; atomic_get(&tx_busy) && waited_ms < TX_ABORT_TIMEOUT_MS; ++waited_ms) {
+        k_sleep(K_MSEC(1));
+    }
+    if (atomic_get(&tx_busy)) {
+        LOG_WRN("UART TX abort did not complete.");
+        atomic_set(&tx_busy, 0);
+    }
+
+    ring_buf_init(&out_ringbuf, sizeof(uart_out_buffer), uart_out_buffer);
+    ring_buf_init(&in_ringbuf, sizeof(uart_in_buffer), uart_in_buffer);
+    k_sem_reset(&in_ringbuf_sem);
+
+    ret = uart_callback_set(params->uart_dev, uart_async_callback, NULL);
+    if (ret) {
+        LOG_ERR("UART async API not available, ret code %d.", ret);
+        return false;
+    }
+
+    atomic_set(&rx_active, 1);
+    ret = uart_rx_start(params->uart_dev);
+    if (ret) {
+        atomic_set(&rx_active, 0);
+        LOG_ERR("Failed to enable UART RX, ret code %d.", ret);
+        return false;
+    }
+
+    atomic_set(&tx_active, 1);
+    LOG_INF("Serial port opened.");
+    return true;
+}
+
+bool zephyr_transport_close(struct uxrCustomTransport * transport){
+    zephyr_transport_params_t * params = (zephyr_transport_params_t*) transport->args;
+
+    atomic_set(&rx_active, 0);
+    atomic_set(&tx_active, 0);
+    (void)uart_rx_disable(params->uart_dev);
+    (void)uart_tx_abort(params->uart_dev);
+    return true;
+}
+
+size_t zephyr_transport_write(struct uxrCustomTransport* transport, const uint8_t * buf, size_t len, uint8_t * err){
+    zephyr_transport_params_t * params = (zephyr_transport_params_t*) transport->args;
+
+    size_t wrote;
+
+    wrote = ring_buf_put(&out_ringbuf, buf, len);
+
+    if (wrote > 0) {
+        uart_tx_kick(params->uart_dev);
+    }
+    if (wrote < len) {
+        atomic_inc(&tx_full);
+        *err = 1;
+    }
+
+    return wrote;
+}
+
+size_t zephyr_transport_read(struct uxrCustomTransport* transport, uint8_t* buf, size_t len, int timeout, uint8_t* err){
+    zephyr_transport_params_t * params = (zephyr_transport_params_t*) transport->args;
+    (void)params;
+
+    size_t read = 0;
+    const k_timepoint_t end = sys_timepoint_calc((timeout < 0) ? K_FOREVER : K_MSEC(timeout));
+
+    /* Block until the UART callback signals new data or the timeout expires */
+    while (ring_buf_is_empty(&in_ringbuf)) {
+        if (k_sem_take(&in_ringbuf_sem, sys_timepoint_timeout(end)) != 0) {
+            return 0;
+        }
+    }
+
+    while (read < len) {
+        uint8_t *data;
+        uint32_t claimed = ring_buf_get_claim(&in_ringbuf, &data, len - read);
+
+        if (claimed == 0) {
+            break;
+        }
+        memcpy(buf + read, data, claimed);
+        ring_buf_get_finish(&in_ringbuf, claimed);
+        read += claimed;
+    }
+
+    return read;
+}
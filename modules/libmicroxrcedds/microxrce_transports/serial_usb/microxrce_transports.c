@@ -18,41 +18,77 @@
 LOG_MODULE_DECLARE(DDS, LOG_LEVEL_INF);
 
 #define RING_BUF_SIZE CONFIG_USB_CDC_ACM_RINGBUF_SIZE
+#define TX_TIMEOUT_MS CONFIG_MICROXRCEDDSCLIENT_SERIAL_USB_TX_TIMEOUT_MS
 
 char uart_in_buffer[RING_BUF_SIZE];
 char uart_out_buffer[RING_BUF_SIZE];
 
 struct ring_buf out_ringbuf, in_ringbuf;
 
+/* Given by the UART callback whenever new bytes land in in_ringbuf */
+K_SEM_DEFINE(in_ringbuf_sem, 0, 1);
+/* Given by the UART callback whenever the FIFO took bytes from out_ringbuf */
+K_SEM_DEFINE(out_ringbuf_sem, 0, 1);
+
+/* ISR timing, written by the UART callback only */
+static zephyr_transport_stats_t transport_stats;
+/* Bumped by every thread writing to the link */
+static atomic_t tx_full;
+
 static void uart_fifo_callback(const struct device *dev, void *user_data){ 
     ARG_UNUSED(user_data);
+    const uint32_t isr_start = k_cycle_get_32();
+
     while (uart_irq_update(dev) && uart_irq_is_pending(dev)) {
         if (uart_irq_rx_ready(dev)) {
+            uint8_t *data;
             int recv_len;
-            char buffer[64];
-            size_t len = MIN(ring_buf_space_get(&in_ringbuf), sizeof(buffer));
+            /* Read the FIFO straight into ring memory, a wrapped ring is
+             * filled by the next pass of the loop */
+            uint32_t len = ring_buf_put_claim(&in_ringbuf, &data, RING_BUF_SIZE);
 
-            if (len > 0){
-                recv_len = uart_fifo_read(dev, buffer, len);
-                ring_buf_put(&in_ringbuf, buffer, recv_len);
+            if (len == 0) {
+                /* Ring full, throttle until zephyr_transport_read drains it */
+                uart_irq_rx_disable(dev);
+                continue;
             }
 
+            recv_len = uart_fifo_read(dev, data, len);
+            ring_buf_put_finish(&in_ringbuf, MAX(recv_len, 0));
+            if (recv_len > 0) {
+                k_sem_give(&in_ringbuf_sem);
+            }
         }
 
-        if (uart_irq_tx_ready(dev)) {			
-            char buffer[64];
-            int rb_len;
-
-            rb_len = ring_buf_get(&out_ringbuf, buffer, sizeof(buffer));
+        if (uart_irq_tx_ready(dev)) {
+            uint8_t *data;
+            int sent;
+            /* Fill the FIFO straight from ring memory, whatever it doesn't
+             * take stays queued for the next pass */
+            uint32_t len = ring_buf_get_claim(&out_ringbuf, &data, RING_BUF_SIZE);
 
-            if (rb_len == 0) {
+            if (len == 0) {
                 uart_irq_tx_disable(dev);
                 continue;
             }
 
-            uart_fifo_fill(dev, buffer, rb_len);
+            sent = uart_fifo_fill(dev, data, len);
+            ring_buf_get_finish(&out_ringbuf, MAX(sent, 0));
+            if (sent > 0) {
+                k_sem_give(&out_ringbuf_sem);
+            }
         }
     }
+
+    const uint32_t isr_cycles = k_cycle_get_32() - isr_start;
+    transport_stats.isr_count++;
+    transport_stats.isr_cycles_total += isr_cycles;
+    transport_stats.isr_cycles_max = MAX(transport_stats.isr_cycles_max, isr_cycles);
+}
+
+void zephyr_transport_get_stats(zephyr_transport_stats_t * stats){
+    *stats = transport_stats;
+    stats->tx_full = (uint32_t)atomic_get(&tx_full);
 }
 
 bool zephyr_transport_open(struct uxrCustomTransport * transport){
@@ -75,6 +111,8 @@ bool zephyr_transport_open(struct uxrCustomTransport * transport){
 
     ring_buf_init(&out_ringbuf, sizeof(uart_out_buffer), uart_out_buffer);
     ring_buf_init(&in_ringbuf, sizeof(uart_in_buffer), uart_in_buffer);
+    k_sem_reset(&in_ringbuf_sem);
+    k_sem_reset(&out_ringbuf_sem);
 
     LOG_INF("Waiting for agent connection.");
 
@@ -126,15 +164,28 @@ bool zephyr_transport_close(struct uxrCustomTransport * transport){
 size_t zephyr_transport_write(struct uxrCustomTransport* transport, const uint8_t * buf, size_t len, uint8_t * err){
     zephyr_transport_params_t * params = (zephyr_transport_params_t*) transport->args;
 
-    size_t wrote;
-    
-    wrote = ring_buf_put(&out_ringbuf, buf, len);
-    
-    if (wrote > 0) {
-        uart_irq_tx_enable(params->uart_dev);
+    size_t wrote = 0;
+    const k_timepoint_t end = sys_timepoint_calc(K_MSEC(TX_TIMEOUT_MS));
+
+    while (true) {
+        wrote += ring_buf_put(&out_ringbuf, buf + wrote, len - wrote);
+        if (wrote > 0) {
+            uart_irq_tx_enable(params->uart_dev);
+        }
+        if (wrote == len) {
+            return wrote;
+        }
+
+        /* Ring full, wait for the FIFO to drain it unless writes never block */
+        if (TX_TIMEOUT_MS == 0 || k_sem_take(&out_ringbuf_sem, sys_timepoint_timeout(end)) != 0) {
+            break;
+        }
     }
-    
-    // Remove blocking wait - return immediately for non-blocking operation
+
+    /* A short write leaves a torn frame the agent drops by its CRC,
+     * count it so the caller sees the link can't keep up */
+    atomic_inc(&tx_full);
+    *err = 1;
     return wrote;
 }
 
@@ -142,17 +193,30 @@ size_t zephyr_transport_read(struct uxrCustomTransport* transport, uint8_t* buf,
     zephyr_transport_params_t * params = (zephyr_transport_params_t*) transport->args;
 
     size_t read = 0;
-    int spent_time_us = 0;
-    const int timeout_us = timeout * 1000;  // Convert timeout to microseconds
-    const int poll_interval_us = 100;       // 100us polling interval like ArduPilot
+    const k_timepoint_t end = sys_timepoint_calc((timeout < 0) ? K_FOREVER : K_MSEC(timeout));
 
-    while(ring_buf_is_empty(&in_ringbuf) && spent_time_us < timeout_us){
-        k_usleep(poll_interval_us);
-        spent_time_us += poll_interval_us;
+    /* Block until the UART callback signals new data or the timeout expires */
+    while (ring_buf_is_empty(&in_ringbuf)) {
+        if (k_sem_take(&in_ringbuf_sem, sys_timepoint_timeout(end)) != 0) {
+            return 0;
+        }
+    }
+
+    /* Single producer / single consumer ring, no need to mask the RX
+     * interrupt while copying out of the claimed regions */
+    while (read < len) {
+        uint8_t *data;
+        uint32_t claimed = ring_buf_get_claim(&in_ringbuf, &data, len - read);
+
+        if (claimed == 0) {
+            break;
+        }
+        memcpy(buf + read, data, claimed);
+        ring_buf_get_finish(&in_ringbuf, claimed);
+        read += claimed;
     }
 
-    uart_irq_rx_disable(params->uart_dev);
-    read = ring_buf_get(&in_ringbuf, buf, len);
+    /* Re-arm RX in case the callback throttled on a full ring */
     uart_irq_rx_enable(params->uart_dev);
 
     return read;
@@ -24,15 +24,28 @@ extern "C"
 {
 #endif
 
+/* Stream oriented link, uXRCE adds HDLC-like framing */
+#define ZEPHYR_TRANSPORT_FRAMING true
+
 typedef struct {
     size_t fd;
     const struct device *uart_dev;
 } zephyr_transport_params_t;
 
+/* Time spent in the transport interrupt/driver callback, for diagnostics */
+typedef struct {
+    uint32_t isr_count;
+    uint32_t isr_cycles_total;
+    uint32_t isr_cycles_max;
+    uint32_t tx_full; /* Writes cut short, the link did not take the data in time */
+    uint32_t rx_dropped; /* Received bytes lost to a full input ring */
+} zephyr_transport_stats_t;
+
 bool zephyr_transport_open(struct uxrCustomTransport * transport);
 bool zephyr_transport_close(struct uxrCustomTransport * transport);
 size_t zephyr_transport_write(struct uxrCustomTransport* transport, const uint8_t * buf, size_t len, uint8_t * err);
 size_t zephyr_transport_read(struct uxrCustomTransport* transport, uint8_t* buf, size_t len, int timeout, uint8_t* err);
+void zephyr_transport_get_stats(zephyr_transport_stats_t * stats);
 
 #ifdef __cplusplus
 }
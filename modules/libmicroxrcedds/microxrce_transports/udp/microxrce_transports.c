@@ -0,0 +1,160 @@
+#include <uxr/client/transport.h>
+
+#include <zephyr/kernel.h>
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "microxrce_transports.h"
+
+#include <zephyr/logging/log.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/net_if.h>
+#if defined(CONFIG_WIFI)
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/wifi_mgmt.h>
+#endif
+
+LOG_MODULE_DECLARE(DDS, LOG_LEVEL_INF);
+
+/* Datagrams the network stack refused to send, bumped by every DDS
+ * thread writing to a socket */
+static atomic_t tx_full;
+
+#if defined(CONFIG_WIFI)
+static bool wifi_connect(struct net_if *iface){
+    struct wifi_connect_req_params wifi = {0};
+
+    wifi.ssid = (const uint8_t *)CONFIG_MICROXRCEDDSCLIENT_WIFI_SSID;
+    wifi.ssid_length = strlen(CONFIG_MICROXRCEDDSCLIENT_WIFI_SSID);
+    wifi.psk = (const uint8_t *)CONFIG_MICROXRCEDDSCLIENT_WIFI_PASSWORD;
+    wifi.psk_length = strlen(CONFIG_MICROXRCEDDSCLIENT_WIFI_PASSWORD);
+    wifi.security = (wifi.psk_length > 0) ? WIFI_SECURITY_TYPE_PSK : WIFI_SECURITY_TYPE_NONE;
+    wifi.channel = WIFI_CHANNEL_ANY;
+    wifi.band = WIFI_FREQ_BAND_2_4_GHZ;
+    wifi.mfp = WIFI_MFP_OPTIONAL;
+
+    int ret = net_mgmt(NET_REQUEST_WIFI_CONNECT, iface, &wifi, sizeof(wifi));
+    if (ret && ret != -EALREADY) {
+        LOG_ERR("WiFi connect request failed, ret code %d.", ret);
+        return false;
+    }
+    return true;
+}
+#endif
+
+bool zephyr_transport_open(struct uxrCustomTransport * transport){
+    zephyr_transport_params_t * params = (zephyr_transport_params_t*) transport->args;
+
+#if !defined(CONFIG_NET_NATIVE_OFFLOADED_SOCKETS)
+    struct net_if *iface = net_if_get_default();
+    if (!iface) {
+        LOG_ERR("No network interface found.");
+        return false;
+    }
+
+#if defined(CONFIG_WIFI)
+    if (!wifi_connect(iface)) {
+        return false;
+    }
+#endif
+
+    LOG_INF("Waiting for network connection.");
+
+    while (!net_if_is_up(iface) || !net_if_ipv4_get_global_addr(iface, NET_ADDR_PREFERRED)) {
+        /* Give CPU resources to low priority threads. */
+        k_sleep(K_MSEC(100));
+    }
+#else
+    /* native_sim sockets are host sockets, the host stack owns the addresses */
+#endif
+
+    struct sockaddr_in agent_addr = {0};
+    agent_addr.sin_family = AF_INET;
+    agent_addr.sin_port = htons((uint16_t)atoi(CONFIG_MICROXRCEDDSCLIENT_AGENT_PORT));
+    if (zsock_inet_pton(AF_INET, CONFIG_MICROXRCEDDSCLIENT_AGENT_IP, &agent_addr.sin_addr) != 1) {
+        LOG_ERR("Invalid agent IP '%s'.", CONFIG_MICROXRCEDDSCLIENT_AGENT_IP);
+        return false;
+    }
+
+    params->fd = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (params->fd < 0) {
+        LOG_ERR("Failed to create UDP socket, errno %d.", errno);
+        return false;
+    }
+
+    /* A connected socket lets the stack drop datagrams from other peers
+     * and skips the per-datagram destination lookup on send */
+    if (zsock_connect(params->fd, (struct sockaddr *)&agent_addr, sizeof(agent_addr)) < 0) {
+        LOG_ERR("Failed to connect UDP socket, errno %d.", errno);
+        zsock_close(params->fd);
+        params->fd = -1;
+        return false;
+    }
+
+    LOG_INF("UDP socket connected to %s:%s.", CONFIG_MICROXRCEDDSCLIENT_AGENT_IP, CONFIG_MICROXRCEDDSCLIENT_AGENT_PORT);
+    return true;
+}
+
+bool zephyr_transport_close(struct uxrCustomTransport * transport){
+    zephyr_transport_params_t * params = (zephyr_transport_params_t*) transport->args;
+
+    if (params->fd >= 0) {
+        zsock_close(params->fd);
+        params->fd = -1;
+    }
+    return true;
+}
+
+size_t zephyr_transport_write(struct uxrCustomTransport* transport, const uint8_t * buf, size_t len, uint8_t * err){
+    zephyr_transport_params_t * params = (zephyr_transport_params_t*) transport->args;
+
+    /* Each XRCE message must travel in its own datagram, submessages are
+     * already packed up to the MTU by the output streams */
+    ssize_t sent = zsock_send(params->fd, buf, len, 0);
+    if (sent < 0) {
+        atomic_inc(&tx_full);
+        *err = 1;
+        return 0;
+    }
+
+    return (size_t)sent;
+}
+
+size_t zephyr_transport_read(struct uxrCustomTransport* transport, uint8_t* buf, size_t len, int timeout, uint8_t* err){
+    zephyr_transport_params_t * params = (zephyr_transport_params_t*) transport->args;
+
+    struct zsock_pollfd fds = {
+        .fd = params->fd,
+        .events = ZSOCK_POLLIN,
+    };
+
+    /* Block in the network stack until a datagram arrives or the timeout expires */
+    int ret = zsock_poll(&fds, 1, (timeout < 0) ? -1 : timeout);
+    if (ret <= 0) {
+        if (ret < 0) {
+            *err = 1;
+        }
+        return 0;
+    }
+
+    ssize_t received = zsock_recv(params->fd, buf, len, ZSOCK_MSG_DONTWAIT);
+    if (received < 0) {
+        if (errno != EAGAIN) {
+            *err = 1;
+        }
+        return 0;
+    }
+
+    return (size_t)received;
+}
+
+void zephyr_transport_get_stats(zephyr_transport_stats_t * stats){
+    /* Datagrams are handled by the network stack threads, no ISR of our own */
+    memset(stats, 0, sizeof(*stats));
+    stats->tx_full = (uint32_t)atomic_get(&tx_full);
+}
@@ -0,0 +1,53 @@
+// Copyright 2021 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _MICROROS_CLIENT_ZEPHYR_TRANSPORT_H_
+#define _MICROROS_CLIENT_ZEPHYR_TRANSPORT_H_
+
+#include <unistd.h>
+#include <zephyr/device.h>
+#include <uxr/client/client.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* One XRCE message per datagram, no framing */
+#define ZEPHYR_TRANSPORT_FRAMING false
+
+typedef struct {
+    int fd;
+} zephyr_transport_params_t;
+
+/* Time spent in the transport interrupt/driver callback, for diagnostics */
+typedef struct {
+    uint32_t isr_count;
+    uint32_t isr_cycles_total;
+    uint32_t isr_cycles_max;
+    uint32_t tx_full; /* Writes cut short, the link did not take the data in time */
+    uint32_t rx_dropped; /* Received bytes lost to a full input ring */
+} zephyr_transport_stats_t;
+
+bool zephyr_transport_open(struct uxrCustomTransport * transport);
+bool zephyr_transport_close(struct uxrCustomTransport * transport);
+size_t zephyr_transport_write(struct uxrCustomTransport* transport, const uint8_t * buf, size_t len, uint8_t * err);
+size_t zephyr_transport_read(struct uxrCustomTransport* transport, uint8_t* buf, size_t len, int timeout, uint8_t* err);
+void zephyr_transport_get_stats(zephyr_transport_stats_t * stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_MICROROS_CLIENT_ZEPHYR_TRANSPORT_H_
\ No newline at end of file
@@ -10,17 +10,20 @@
 #include "microxrce_transports.h"
 
 #include "mirac_dds_frames.h"
+#include "mirac_dds_log.h"
 #include "mirac_dds_client.h"
 #include "mirac_dds_topic_list.h"
+#if defined(CONFIG_MICROXRCEDDSCLIENT_SHARED_LINK)
+#include "mirac_dds_link.h"
+#endif
 
 LOG_MODULE_REGISTER(DDS, LOG_LEVEL_INF);
 
-static zephyr_transport_params_t default_params;
-
-// Thread stack and thread control block
-#define DDS_THREAD_STACK_SIZE 8192
+// Stack of the instance that doesn't bring its own, further instances
+// pass config::stack
+#define DDS_THREAD_STACK_SIZE CONFIG_MICROXRCEDDSCLIENT_THREAD_STACK_SIZE
 K_THREAD_STACK_DEFINE(dds_thread_stack, DDS_THREAD_STACK_SIZE);
-static struct k_thread dds_thread_data;
+static atomic_t dds_thread_stack_taken = ATOMIC_INIT(0);
 
 // Thread static entry wrapper
 static void miracdds_thread_entry(void *p1, void *p2, void *p3)
@@ -32,15 +35,31 @@ static void miracdds_thread_entry(void *p1, void *p2, void *p3)
     }
 }
 
-MiracDDS::MiracDDS()
-    : session_{}, transport_{}, is_status_ok_{false}, is_connected_{false}, 
+MiracDDS::MiracDDS() : MiracDDS(config{})
+{
+}
+
+MiracDDS::MiracDDS(const config &cfg)
+    : config_{cfg}, thread_data_{}, session_{}, transport_{}, transport_args_{}, is_status_ok_{false}, is_connected_{false}, 
       reliable_out_{}, reliable_in_{},
-      last_time_syncd_time_ms_{0},
-      talker_topic_{}, last_talker_time_ms_{0},
-      rx_chatter_topic_{}
+      best_effort_out_{}, best_effort_in_{},
+#if defined(CONFIG_MICROXRCEDDSCLIENT_CONTROL_STREAM)
+      control_out_{},
+#endif
+      last_time_syncd_time_ms_{0}, time_sync_sent_ms_{0},
+      clock_{(int64_t)MAX(DDS_DELAY_TIME_SYNC_MS, 1000) * 1000000},
+      scheduler_{},
+      publishers_{}, streams_{}, readers_{}, rx_sample_{},
+      topic_stats_{}, session_stats_{}, pending_samples_{0}, diagnostics_cursor_{0}
 {
-    // Initialize message defaults if needed
-    talker_topic_.data[0] = '\0';
+#if defined(CONFIG_MICROXRCEDDSCLIENT_SHARED_LINK)
+    if (config_.link)
+    {
+        const int port = config_.link->attach(config_.client_key);
+        transport_args_.link = (port == MiracDDSLink::INVALID_PORT) ? nullptr : config_.link;
+        transport_args_.port = (uint8_t)port;
+    }
+#endif
 }
 
 MiracDDS::~MiracDDS()
@@ -54,13 +73,26 @@ MiracDDS::~MiracDDS()
 
 bool MiracDDS::startThread()
 {
+    k_thread_stack_t *stack = config_.stack;
+    stack_size_ = config_.stack_size;
+    if (!stack)
+    {
+        if (!atomic_cas(&dds_thread_stack_taken, 0, 1))
+        {
+            LOG_ERR("Built-in DDS thread stack in use, pass config::stack.");
+            return false;
+        }
+        stack = dds_thread_stack;
+        stack_size_ = K_THREAD_STACK_SIZEOF(dds_thread_stack);
+    }
+
     // Create Zephyr thread
-    k_tid_t tid = k_thread_create(&dds_thread_data,
-                                  dds_thread_stack,
-                                  K_THREAD_STACK_SIZEOF(dds_thread_stack),
+    k_tid_t tid = k_thread_create(&thread_data_,
+                                  stack,
+                                  stack_size_,
                                   miracdds_thread_entry,
                                   this, nullptr, nullptr,
-                                  CONFIG_MAIN_THREAD_PRIORITY + 1,
+                                  config_.thread_priority,
                                   0,
                                   K_NO_WAIT);
     if (!tid)
@@ -68,6 +100,7 @@ bool MiracDDS::startThread()
         LOG_ERR("Failed to create DDS thread.");
         return false;
     }
+    k_thread_name_set(tid, config_.thread_name);
 
     LOG_INF("DDS thread started.");
     return true;
@@ -83,88 +116,146 @@ void MiracDDS::mainLoop()
 
     while (true)
     {
+#if defined(CONFIG_MICROXRCEDDSCLIENT_SHARED_LINK)
+        // Replies without a client key reach us only while connecting
+        if (transport_args_.link)
+        {
+            transport_args_.link->setConnecting(transport_args_.port, true);
+        }
+#endif
         if (!uxr_ping_agent_attempts(&transport_.comm, DDS_PING_TIMEOUT_MS, DDS_PING_MAX_RETRY))
         {
             LOG_WRN("No ping response, retrying.");
             continue;
         }
 
-        if (!initSession() || !createEntities())
+        const bool session_ok = initSession();
+#if defined(CONFIG_MICROXRCEDDSCLIENT_SHARED_LINK)
+        if (transport_args_.link)
         {
-            LOG_ERR("Session init requests failed.");
-            return;
+            transport_args_.link->setConnecting(transport_args_.port, false);
+        }
+#endif
+        if (!session_ok || !createEntities())
+        {
+            // Usually the agent restarting under us, drop what it may hold
+            // of this session and start over from the ping
+            LOG_ERR("Session init requests failed, retrying.");
+            if (session_ok)
+            {
+                (void)uxr_delete_session_retries(&session_, 1);
+            }
+            k_msleep(DDS_SESSION_RETRY_DELAY_MS);
+            continue;
         }
         is_connected_ = true;
         LOG_INF("DDS Client Initialization Good.");
 
-        int64_t cur_time_ms = uxr_millis();
+        ++session_stats_.sessions;
+
+        int64_t cur_time_ms;
 
+        // Any inbound traffic proves the agent alive, ping only once the
+        // link has been quiet for a whole interval
         int64_t last_ping_ms = 0;
         size_t num_pings_missed = 0;
-        bool had_ping_reply = false;
+        transport_args_.last_rx_ms = uxr_millis();
 
-        uxr_sync_session(&session_, DDS_REQ_TIMEOUT_MS);
-        last_time_syncd_time_ms_ = cur_time_ms;
-        LOG_DBG("Time synchronized. offset: %" PRId64 " us", session_.time_offset / 1000);
-        while (isConnected())
+        // Nothing is published yet, wait for the first reply so stamps
+        // start out right; later syncs run in the background
+        time_sync_sent_ms_ = 0;
+        last_time_syncd_time_ms_ = uxr_millis();
+        if (!uxr_sync_session(&session_, DDS_REQ_TIMEOUT_MS))
         {
-            // Reduce sleep to allow higher frequency operation
-            // Use microsecond delay for better timing precision
-            k_usleep(100);
+            // No reply, retry in the background a second from now
+            LOG_WRN("No time sync reply, retrying.");
+            last_time_syncd_time_ms_ = uxr_millis() - DDS_DELAY_TIME_SYNC_MS + 1000;
+        }
 
+        scheduleTopics();
+        while (isConnected())
+        {
             // publish topics
             update();
 
-            // check ping response
-            if (session_.on_pong_flag == PONG_IN_SESSION_STATUS)
+            // Heard from the agent since the last ping, pong or anything else
+            const int64_t last_rx_ms = transport_args_.last_rx_ms;
+            if (last_rx_ms > last_ping_ms)
             {
-                had_ping_reply = true;
+                num_pings_missed = 0;
             }
 
             cur_time_ms = uxr_millis();
-            if (cur_time_ms - last_ping_ms > DDS_REQ_TIMEOUT_MS)
+            if (cur_time_ms - MAX(last_rx_ms, last_ping_ms) >= DDS_PING_INTERVAL_MS)
             {
-                last_ping_ms = cur_time_ms;
-
-                if (had_ping_reply)
+                // The previous ping got no answer within a whole interval
+                if (last_ping_ms > last_rx_ms)
                 {
-                    num_pings_missed = 0;
+                    ++num_pings_missed;
+                    ++session_stats_.pings_missed;
                 }
-                else
+
+                if (num_pings_missed >= DDS_PING_MISS_THRESHOLD)
                 {
-                    ++num_pings_missed;
+                    LOG_ERR("No traffic from the agent, disconnecting.");
+                    is_connected_ = false;
+                    break;
                 }
 
                 const int ping_agent_timeout_ms = 0;
                 const uint8_t ping_agent_attempts = 1;
                 uxr_ping_agent_session(&session_, ping_agent_timeout_ms, ping_agent_attempts);
-
-                had_ping_reply = false;
+                last_ping_ms = cur_time_ms;
             }
 
-            if (num_pings_missed > 2)
-            {
-                LOG_ERR("No ping response, disconnecting.");
-                is_connected_ = false;
-            }
+            // Sleep in the transport until the next publisher or ping is due,
+            // inbound traffic is handled as soon as it arrives
+            const int64_t ping_due_ms = MAX(transport_args_.last_rx_ms, last_ping_ms) + DDS_PING_INTERVAL_MS - uxr_millis();
+            spinOnce(MAX(1, (int)MIN((int64_t)nextDeadlineMs(), ping_due_ms)));
         }
 
-        cleanup();
-        LOG_INF("DDS Client closed.");
+        // Keep the transport open and the session key as is, the agent
+        // still holds our entities if only the link went away
+        LOG_INF("DDS Client link lost, reconnecting.");
     }
 }
 
 bool MiracDDS::initTransport()
 {
+#if defined(CONFIG_MICROXRCEDDSCLIENT_SHARED_LINK)
+    if (config_.link && !transport_args_.link)
+    {
+        LOG_ERR("No port on the shared link.");
+        return false;
+    }
+    if (transport_args_.link)
+    {
+        // The link frames the byte stream, we exchange whole messages
+        uxr_set_custom_transport_callbacks(&transport_,
+                                           false,
+                                           MiracDDS::link_open,
+                                           MiracDDS::link_close,
+                                           MiracDDS::link_write,
+                                           MiracDDS::link_read);
+        if (!uxr_init_custom_transport(&transport_, &transport_args_))
+        {
+            LOG_ERR("Transport initialization failed.");
+            return false;
+        }
+        return true;
+    }
+#endif
+
     // Initialize Zephyr custom transport
     uxr_set_custom_transport_callbacks(&transport_,
-                                       true,
+                                       ZEPHYR_TRANSPORT_FRAMING,
                                        zephyr_transport_open,
                                        zephyr_transport_close,
                                        zephyr_transport_write,
-                                       zephyr_transport_read);
+                                       MiracDDS::transport_read);
 
-    if (!uxr_init_custom_transport(&transport_, &default_params))
+    // transport_args_ starts with the transport's own params
+    if (!uxr_init_custom_transport(&transport_, &transport_args_))
     {
         LOG_ERR("Transport initialization failed.");
         return false;
@@ -172,12 +263,61 @@ bool MiracDDS::initTransport()
     return true;
 }
 
+size_t MiracDDS::transport_read(uxrCustomTransport *transport, uint8_t *buf, size_t len, int timeout, uint8_t *err)
+{
+    const size_t read = zephyr_transport_read(transport, buf, len, timeout, err);
+    if (read > 0)
+    {
+        static_cast<transportArgs *>(transport->args)->last_rx_ms = uxr_millis();
+    }
+    return read;
+}
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_SHARED_LINK)
+bool MiracDDS::link_open(uxrCustomTransport *transport)
+{
+    return static_cast<transportArgs *>(transport->args)->link->open();
+}
+
+bool MiracDDS::link_close(uxrCustomTransport *transport)
+{
+    // The link outlives the sessions on it
+    (void)transport;
+    return true;
+}
+
+size_t MiracDDS::link_write(uxrCustomTransport *transport, const uint8_t *buf, size_t len, uint8_t *err)
+{
+    return static_cast<transportArgs *>(transport->args)->link->write(buf, len, err);
+}
+
+size_t MiracDDS::link_read(uxrCustomTransport *transport, uint8_t *buf, size_t len, int timeout, uint8_t *err)
+{
+    transportArgs *args = static_cast<transportArgs *>(transport->args);
+    const size_t read = args->link->read(args->port, buf, len, timeout, err);
+    if (read > 0)
+    {
+        args->last_rx_ms = uxr_millis();
+    }
+    return read;
+}
+#endif
+
 bool MiracDDS::initSession()
 {
-    uxr_init_session(&session_, &transport_.comm, client_key);
+    uxr_init_session(&session_, &transport_.comm, config_.client_key);
+#if defined(CONFIG_MICROXRCEDDSCLIENT_SHARED_LINK)
+    if (transport_args_.link)
+    {
+        // Session ids below 0x80 carry the client key in every message
+        // header both ways, the link routes replies by it
+        session_.info.id = (uint8_t)(transport_args_.port + 1);
+    }
+#endif
 
     // Register topic callbacks
     uxr_set_topic_callback(&session_, MiracDDS::on_topic_entry, this);
+    uxr_set_time_callback(&session_, MiracDDS::on_time_entry, this);
 
     if (!uxr_create_session(&session_))
     {
@@ -185,14 +325,23 @@ bool MiracDDS::initSession()
         return false;
     }
 
-    memset(output_buffer_, 0, DDS_BUFFER_SIZE);
-    memset(input_buffer_, 0, DDS_BUFFER_SIZE);
+    // Stream creation resets its own bookkeeping, no need to clear the buffers
+#if defined(CONFIG_MICROXRCEDDSCLIENT_CONTROL_STREAM)
+    // Reliable streams are flushed in creation order, control goes first
+    control_out_ = uxr_create_output_reliable_stream(
+        &session_, control_output_buffer_, sizeof(control_output_buffer_), DDS_CONTROL_OUTPUT_HISTORY);
+#endif
 
     reliable_out_ = uxr_create_output_reliable_stream(
-        &session_, output_buffer_, DDS_BUFFER_SIZE, DDS_STREAM_HISTORY);
+        &session_, output_buffer_, sizeof(output_buffer_), DDS_OUTPUT_RELIABLE_HISTORY);
 
     reliable_in_ = uxr_create_input_reliable_stream(
-        &session_, input_buffer_, DDS_BUFFER_SIZE, DDS_STREAM_HISTORY);
+        &session_, input_buffer_, sizeof(input_buffer_), DDS_INPUT_RELIABLE_HISTORY);
+
+    best_effort_out_ = uxr_create_output_best_effort_stream(
+        &session_, best_effort_output_buffer_, sizeof(best_effort_output_buffer_));
+
+    best_effort_in_ = uxr_create_input_best_effort_stream(&session_);
 
     LOG_INF("Session init complete.");
     return true;
@@ -200,102 +349,427 @@ bool MiracDDS::initSession()
 
 bool MiracDDS::createEntities()
 {
-    // Create Participant
     const uxrObjectId participant_id = uxr_object_id(DDS_PARTICIPANT_ID, UXR_PARTICIPANT_ID);
-    const uint16_t participant_req = uxr_buffer_create_participant_bin(&session_, reliable_out_, participant_id,
-                                                                       ROS_DOMAIN_ID, DDS_PARTICIPANT_NAME, UXR_REPLACE);
+    const size_t topics_count = sizeof(topics) / sizeof(topics[0]);
+    LOG_DBG("Topics Count = %u", (unsigned)topics_count);
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS)
+    // Overrides changed from here on are applied by the first update()
+    topic_config_version_ = topicConfigVersion();
+    memset(created_, 0, sizeof(created_));
+    memset(active_, 0, sizeof(active_));
+#endif
+
+    createBatch batch{};
 
-    const uint16_t request_participant[1] = {participant_req};
-    uint8_t status_participant[1] = {0};
-    if (!uxr_run_session_until_all_status(&session_, DDS_REQ_TIMEOUT_MS, request_participant, status_participant, 1))
+    // Create Participant, topics refer to it further down the same stream
+    const bool participant_ok = bufferCreate(batch, "Participant", -1, [&]()
+    {
+        return DDS_CREATE_BY_REF
+            ? uxr_buffer_create_participant_ref(&session_, reliable_out_, participant_id,
+                                                ROS_DOMAIN_ID, config_.participant_name, DDS_CREATE_FLAGS)
+            : uxr_buffer_create_participant_bin(&session_, reliable_out_, participant_id,
+                                                ROS_DOMAIN_ID, config_.participant_name, DDS_CREATE_FLAGS);
+    });
+    if (!participant_ok)
     {
-        LOG_ERR("Participant session request failure.");
         return false;
     }
 
-    const size_t topics_count = sizeof(topics) / sizeof(topics[0]);
-    LOG_DBG("Topics Count = %u", (unsigned)topics_count);
+    // Disabled topics are left out until they are enabled
+    for (size_t i = 0; i < topics_count; ++i)
+    {
+        if (serves(i) && topicEnabled(i) && !bufferTopicEntities(batch, i))
+        {
+            return false;
+        }
+    }
 
+    // Single round-trip for everything still in flight
+    if (!waitCreateBatch(&session_, batch))
+    {
+        return false;
+    }
+    session_stats_.entities_reused = batch.reused;
+    LOG_INF("%u of %u entities reused from the agent.", (unsigned)batch.reused, (unsigned)batch.total);
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS)
+    for (size_t i = 0; i < topics_count; ++i)
+    {
+        created_[i] = active_[i] = serves(i) && topicEnabled(i);
+    }
+#endif
+
+    // Read requests do not outlive the session, renew them every time
     for (size_t i = 0; i < topics_count; ++i)
     {
         const auto &t = topics[i];
+        if (!isActive(i) || t.role_type != topicRole::TOPIC_ROLE_SUB)
+        {
+            continue;
+        }
+        const uxrDeliveryControl delivery = deliveryControl(t);
+        if (uxr_buffer_request_data(&session_, reliable_out_, t.data_entity_id, inputStream(t), &delivery) == UXR_INVALID_REQUEST_ID)
+        {
+            LOG_ERR("Failed to request data for index '%u'", (unsigned)i);
+        }
+    }
 
-        // Create Topic
-        const uint16_t topic_req_id =
-            uxr_buffer_create_topic_bin(&session_, reliable_out_, t.topic_id,
-                                        participant_id, t.topic_name, t.type_name, UXR_REPLACE);
-
-        // Create Publisher / Subscriber
-        const uint16_t role_req_id =
-            (t.role_type == topicRole::TOPIC_ROLE_PUB)
-                ? uxr_buffer_create_publisher_bin(&session_, reliable_out_, t.role_id, participant_id, UXR_REPLACE)
-                : uxr_buffer_create_subscriber_bin(&session_, reliable_out_, t.role_id, participant_id, UXR_REPLACE);
-
-        // Create DataWriter / DataReader
-        const uint16_t data_entity_req_id =
-            (t.role_type == topicRole::TOPIC_ROLE_PUB)
-                ? uxr_buffer_create_datawriter_bin(&session_, reliable_out_, t.data_entity_id, t.role_id, t.topic_id, t.qos, UXR_REPLACE)
-                : uxr_buffer_create_datareader_bin(&session_, reliable_out_, t.data_entity_id, t.role_id, t.topic_id, t.qos, UXR_REPLACE);
-
-        const uint16_t requests[3] = {topic_req_id, role_req_id, data_entity_req_id};
-        uint8_t status[3] = {0, 0, 0};
-
-        if (!uxr_run_session_until_all_status(&session_, DDS_REQ_TIMEOUT_MS, requests, status, 3))
-        {
-            LOG_ERR("Topic/%s/%s session request failure for index '%u'",
-                    (t.role_type == topicRole::TOPIC_ROLE_PUB) ? "Pub" : "Sub",
-                    (t.role_type == topicRole::TOPIC_ROLE_PUB) ? "Writer" : "Reader",
-                    (unsigned)i);
-            LOG_ERR("Status 'Topic' result '%u'", status[0]);
-            LOG_ERR("Status '%s' result '%u'",
-                    (t.role_type == topicRole::TOPIC_ROLE_PUB) ? "Pub" : "Sub",
-                    status[1]);
-            LOG_ERR("Status 'Data %s' result '%u'",
-                    (t.role_type == topicRole::TOPIC_ROLE_PUB) ? "Writer" : "Reader",
-                    status[2]);
+    LOG_INF("Client initialized successfully.");
+    return true;
+}
+
+template <typename CreateFn>
+bool MiracDDS::bufferCreate(createBatch &batch, const char *entity, int16_t index, CreateFn &&create)
+{
+    if (batch.count == createBatch::CAPACITY && !waitCreateBatch(&session_, batch))
+    {
+        return false;
+    }
+
+    uint16_t req_id = create();
+    if (req_id == UXR_INVALID_REQUEST_ID)
+    {
+        if (!waitCreateBatch(&session_, batch))
+        {
             return false;
         }
+        req_id = create();
+    }
+    if (req_id == UXR_INVALID_REQUEST_ID)
+    {
+        LOG_ERR("Failed to buffer '%s' request for index '%d'", entity, index);
+        return false;
+    }
+
+    batch.requests[batch.count] = req_id;
+    batch.entity[batch.count] = entity;
+    batch.topic_index[batch.count] = index;
+    ++batch.count;
+    return true;
+}
+
+bool MiracDDS::bufferTopicEntities(createBatch &batch, size_t i)
+{
+    const uxrObjectId participant_id = uxr_object_id(DDS_PARTICIPANT_ID, UXR_PARTICIPANT_ID);
+    const auto &t = topics[i];
+    const bool is_pub = (t.role_type == topicRole::TOPIC_ROLE_PUB);
+    const bool by_ref = DDS_CREATE_BY_REF && (t.profile_ref != nullptr);
+    const int16_t index = static_cast<int16_t>(i);
+
+    // Create Topic
+    const bool topic_ok = bufferCreate(batch, "Topic", index, [&]()
+    {
+        return by_ref
+            ? uxr_buffer_create_topic_ref(&session_, reliable_out_, t.topic_id,
+                                          participant_id, t.profile_ref, DDS_CREATE_FLAGS)
+            : uxr_buffer_create_topic_bin(&session_, reliable_out_, t.topic_id,
+                                          participant_id, t.topic_name, t.msg_type->type_name, DDS_CREATE_FLAGS);
+    });
+
+    // Create Publisher / Subscriber
+    const bool role_ok = topic_ok && bufferCreate(batch, is_pub ? "Pub" : "Sub", index, [&]()
+    {
+        return is_pub
+            ? uxr_buffer_create_publisher_bin(&session_, reliable_out_, t.role_id, participant_id, DDS_CREATE_FLAGS)
+            : uxr_buffer_create_subscriber_bin(&session_, reliable_out_, t.role_id, participant_id, DDS_CREATE_FLAGS);
+    });
+
+    // Create DataWriter / DataReader
+    return role_ok && bufferCreate(batch, is_pub ? "Data Writer" : "Data Reader", index, [&]()
+    {
+        if (by_ref)
+        {
+            return is_pub
+                ? uxr_buffer_create_datawriter_ref(&session_, reliable_out_, t.data_entity_id, t.role_id, t.profile_ref, DDS_CREATE_FLAGS)
+                : uxr_buffer_create_datareader_ref(&session_, reliable_out_, t.data_entity_id, t.role_id, t.profile_ref, DDS_CREATE_FLAGS);
+        }
+        return is_pub
+            ? uxr_buffer_create_datawriter_bin(&session_, reliable_out_, t.data_entity_id, t.role_id, t.topic_id, t.qos, DDS_CREATE_FLAGS)
+            : uxr_buffer_create_datareader_bin(&session_, reliable_out_, t.data_entity_id, t.role_id, t.topic_id, t.qos, DDS_CREATE_FLAGS);
+    });
+}
+
+bool MiracDDS::waitCreateBatch(uxrSession *session, createBatch &batch)
+{
+    if (batch.count == 0)
+    {
+        return true;
+    }
+
+    const bool ok = uxr_run_session_until_all_status(session, DDS_REQ_TIMEOUT_MS, batch.requests, batch.status, batch.count);
+    for (size_t i = 0; i < batch.count; ++i)
+    {
+        const uint8_t status = batch.status[i];
+        if (status == UXR_STATUS_OK_MATCHED)
+        {
+            ++batch.reused;
+        }
+        if (status == UXR_STATUS_OK || status == UXR_STATUS_OK_MATCHED)
+        {
+            LOG_DBG("Status '%s' pass for index '%d'", batch.entity[i], batch.topic_index[i]);
+        }
         else
         {
-            LOG_DBG("Topic/%s/%s session pass for index '%u'",
-                    (t.role_type == topicRole::TOPIC_ROLE_PUB) ? "Pub" : "Sub",
-                    (t.role_type == topicRole::TOPIC_ROLE_PUB) ? "Writer" : "Reader",
-                    (unsigned)i);
-            if (t.role_type == topicRole::TOPIC_ROLE_SUB) uxr_buffer_request_data(&session_, reliable_out_, t.data_entity_id, reliable_in_, &delivery_control);
+            LOG_ERR("Status '%s' result '%u' for index '%d'", batch.entity[i], status, batch.topic_index[i]);
         }
     }
 
-    LOG_INF("Client initialized successfully.");
-    return true;
+    LOG_DBG("Create batch of %u requests %s", (unsigned)batch.count, ok ? "passed" : "failed");
+    batch.total += batch.count;
+    batch.count = 0;
+    return ok;
 }
 
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS)
+void MiracDDS::applyTopicConfig()
+{
+    // Changes made while this runs are picked up by the next pass
+    topic_config_version_ = topicConfigVersion();
+    const size_t topics_count = sizeof(topics) / sizeof(topics[0]);
+
+    // Only the topics enabled for the first time this session are created,
+    // the participant and everything else stay as they are
+    createBatch batch{};
+    bool create_ok = true;
+    for (size_t i = 0; i < topics_count && create_ok; ++i)
+    {
+        if (serves(i) && topicEnabled(i) && !created_[i])
+        {
+            create_ok = bufferTopicEntities(batch, i);
+        }
+    }
+    create_ok = waitCreateBatch(&session_, batch) && create_ok;
+    if (!create_ok)
+    {
+        // Tried again on the next change or reconnect
+        LOG_ERR("Failed to create newly enabled topics.");
+    }
+    else if (batch.total > 0)
+    {
+        LOG_INF("%u entities created for newly enabled topics.", (unsigned)batch.total);
+    }
+
+    const int64_t now_ms = uxr_millis();
+    for (size_t i = 0; i < topics_count; ++i)
+    {
+        const auto &t = topics[i];
+        if (!serves(i))
+        {
+            continue;
+        }
+        if (create_ok && topicEnabled(i))
+        {
+            created_[i] = true;
+        }
+
+        const bool active = topicEnabled(i) && created_[i];
+        if (t.role_type == topicRole::TOPIC_ROLE_PUB)
+        {
+            // Only a topic whose state or rate changed is re-armed, the
+            // others keep their phase
+            const uint32_t period_ms = active ? topicRate(i) : 0;
+            if (scheduler_.period(static_cast<uint8_t>(i)) != period_ms)
+            {
+                (void)scheduler_.remove(static_cast<uint8_t>(i));
+                (void)scheduler_.add(static_cast<uint8_t>(i), period_ms, now_ms);
+            }
+        }
+
+        if (active == active_[i])
+        {
+            continue;
+        }
+        active_[i] = active;
+
+        if (t.role_type == topicRole::TOPIC_ROLE_SUB)
+        {
+            const uxrDeliveryControl delivery = deliveryControl(t);
+            const uint16_t req_id = active
+                ? uxr_buffer_request_data(&session_, reliable_out_, t.data_entity_id, inputStream(t), &delivery)
+                : uxr_buffer_cancel_data(&session_, reliable_out_, t.data_entity_id);
+            if (req_id == UXR_INVALID_REQUEST_ID)
+            {
+                LOG_ERR("Failed to %s data for index '%u'", active ? "request" : "cancel", (unsigned)i);
+            }
+        }
+        else if (active && publishers_[i])
+        {
+            // Samples queued while the topic was off are stale by now
+            while (publishers_[i]->front() != nullptr)
+            {
+                publishers_[i]->pop();
+            }
+        }
+    }
+}
+#endif
+
 bool MiracDDS::spinOnce(int timeout_ms)
 {
-    is_status_ok_ = uxr_run_session_time(&session_, timeout_ms);
+    const uint32_t start = k_cycle_get_32();
+
+    // Bounded by timeout_ms even while inbound traffic keeps arriving
+    is_status_ok_ = uxr_run_session_timeout(&session_, timeout_ms);
+
+    // Returning late means the thread was starved rather than idle
+    const uint32_t cycles = k_cycle_get_32() - start;
+    ++session_stats_.spins;
+    session_stats_.spin_cycles_max = MAX(session_stats_.spin_cycles_max, cycles);
+    if (k_cyc_to_us_floor32(cycles) > (uint32_t)timeout_ms * 1000U + 1000U)
+    {
+        ++session_stats_.spin_overruns;
+    }
     return is_status_ok_;
 }
 
 void MiracDDS::update()
 {
-    const int64_t cur_time_ms = uxr_epoch_millis(&session_);
+    // Timers run on the local monotonic clock, the synchronized epoch
+    // clock may jump whenever the time offset is updated
+    const int64_t cur_time_ms = uxr_millis();
 
-    if (cur_time_ms - last_time_syncd_time_ms_ > DDS_DELAY_TIME_SYNC_MS)
+    if (time_sync_sent_ms_ != 0 && cur_time_ms - time_sync_sent_ms_ > DDS_REQ_TIMEOUT_MS)
     {
-        uxr_sync_session(&session_, DDS_REQ_TIMEOUT_MS);
-        last_time_syncd_time_ms_ = cur_time_ms;
-        LOG_DBG("Time synchronized. offset: %" PRId64 " us", session_.time_offset / 1000);
+        // Reply lost, try again a second from now
+        time_sync_sent_ms_ = 0;
+        last_time_syncd_time_ms_ = MIN(last_time_syncd_time_ms_, cur_time_ms - DDS_DELAY_TIME_SYNC_MS + 1000);
+    }
+    if (time_sync_sent_ms_ == 0 && cur_time_ms - last_time_syncd_time_ms_ > DDS_DELAY_TIME_SYNC_MS)
+    {
+        requestTimeSync();
     }
 
-    if (cur_time_ms - last_talker_time_ms_ > DDS_DELAY_TALKER_TOPIC_MS)
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS)
+    if (topic_config_version_ != topicConfigVersion())
     {
-        const char msg[] = "Hello from Zephyr!";
-        updateTopic(&talker_topic_, msg);
-        last_talker_time_ms_ = cur_time_ms;
-        // LOG_DBG("Publish string_topic: %s", string_topic_.data);
-        (void)writeTopicTalker();
+        applyTopicConfig();
     }
+#endif
 
-    spinOnce(1);
+    // Control topics are written ahead of telemetry due in the same pass
+    size_t due_telemetry = 0;
+    uint8_t index;
+    while (scheduler_.popDue(cur_time_ms, index, DDS_BATCH_WINDOW_MS))
+    {
+        // popDue yields each entry at most once per pass, so the list can't
+        // outgrow the scheduler; should it fill anyway, publish in place
+        if (topics[index].priority == topicPriority::PRIORITY_CONTROL || due_telemetry == DDS_MAX_TOPICS)
+        {
+            publishTopic(index);
+        }
+        else
+        {
+            due_telemetry_[due_telemetry++] = index;
+        }
+    }
+
+    // Unscheduled publishers go out on every pass of the DDS thread
+    const size_t topics_count = sizeof(topics) / sizeof(topics[0]);
+    for (size_t i = 0; i < topics_count; ++i)
+    {
+        if (topics[i].priority == topicPriority::PRIORITY_CONTROL && isUnscheduled(i))
+        {
+            publishTopic(static_cast<uint8_t>(i));
+        }
+    }
+
+    if (telemetryThrottled(cur_time_ms))
+    {
+        // Deferred telemetry waits for the next deadline, unscheduled
+        // telemetry for the next pass
+        ++session_stats_.throttled;
+    }
+    else
+    {
+        for (size_t i = 0; i < due_telemetry; ++i)
+        {
+            publishTopic(due_telemetry_[i]);
+        }
+        for (size_t i = 0; i < topics_count; ++i)
+        {
+            if (topics[i].priority == topicPriority::PRIORITY_TELEMETRY && isUnscheduled(i))
+            {
+                publishTopic(static_cast<uint8_t>(i));
+            }
+        }
+    }
+
+    // Samples of this pass were packed into as few stream slots as they
+    // fit, send them all in one go
+    if (pending_samples_ > 0)
+    {
+        uxr_flash_output_streams(&session_);
+        ++session_stats_.flushes;
+        session_stats_.flushed_samples += pending_samples_;
+        pending_samples_ = 0;
+    }
+}
+
+bool MiracDDS::telemetryThrottled(int64_t now_ms)
+{
+    if (DDS_TELEMETRY_BACKOFF_MS == 0)
+    {
+        return false;
+    }
+
+    // A write cut short by a full transport means the link is not keeping
+    // up, leave it to the control topics for a while
+    zephyr_transport_stats_t transport_stats{};
+    zephyr_transport_get_stats(&transport_stats);
+    if (transport_stats.tx_full != last_tx_full_)
+    {
+        last_tx_full_ = transport_stats.tx_full;
+        telemetry_resume_ms_ = now_ms + DDS_TELEMETRY_BACKOFF_MS;
+    }
+    return now_ms < telemetry_resume_ms_;
+}
+
+int MiracDDS::nextDeadlineMs() const
+{
+    const int64_t now_ms = uxr_millis();
+    int64_t next_ms = MIN(scheduler_.nextDeadline(), last_time_syncd_time_ms_ + DDS_DELAY_TIME_SYNC_MS);
+    if (time_sync_sent_ms_ != 0)
+    {
+        // Wake up to retry a lost sync reply, update() checks for strictly later
+        next_ms = MIN(next_ms, time_sync_sent_ms_ + DDS_REQ_TIMEOUT_MS + 1);
+    }
+    return (int)CLAMP(next_ms - now_ms, 0, (int64_t)INT32_MAX);
+}
+
+MiracDDS::threadStats MiracDDS::threadUsage() const
+{
+    threadStats usage{};
+    usage.stack_size = stack_size_;
+
+#if defined(CONFIG_THREAD_STACK_INFO)
+    size_t unused = 0;
+    if (k_thread_stack_space_get(&thread_data_, &unused) == 0)
+    {
+        usage.stack_unused = unused;
+    }
+#endif
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+    k_thread_runtime_stats_t rt{};
+    if (k_thread_runtime_stats_get(const_cast<k_tid_t>(&thread_data_), &rt) == 0)
+    {
+        usage.cycles = rt.execution_cycles;
+    }
+    if (k_thread_runtime_stats_all_get(&rt) == 0)
+    {
+        usage.cycles_all = rt.execution_cycles;
+    }
+#endif
+
+    zephyr_transport_stats_t transport_stats;
+    zephyr_transport_get_stats(&transport_stats);
+    usage.isr_count = transport_stats.isr_count;
+    usage.isr_cycles_max = transport_stats.isr_cycles_max;
+    usage.isr_cycles_total = transport_stats.isr_cycles_total;
+    usage.tx_full = transport_stats.tx_full;
+    usage.rx_dropped = transport_stats.rx_dropped;
+    return usage;
 }
 
 bool MiracDDS::isConnected() const
@@ -318,31 +792,338 @@ void MiracDDS::cleanup()
 // Private: topic publishing
 //---------------------------------------------------------------------
 
-bool MiracDDS::writeTopicTalker()
+uxrStreamId MiracDDS::outputStream(const topicList &t) const
+{
+    if (t.qos.reliability == UXR_RELIABILITY_BEST_EFFORT)
+    {
+        return best_effort_out_;
+    }
+#if defined(CONFIG_MICROXRCEDDSCLIENT_CONTROL_STREAM)
+    if (t.priority == topicPriority::PRIORITY_CONTROL)
+    {
+        return control_out_;
+    }
+#endif
+    return reliable_out_;
+}
+
+uxrStreamId MiracDDS::inputStream(const topicList &t) const
+{
+    return (t.qos.reliability == UXR_RELIABILITY_BEST_EFFORT) ? best_effort_in_ : reliable_in_;
+}
+
+uxrDeliveryControl MiracDDS::deliveryControl(const topicList &t)
+{
+    uxrDeliveryControl delivery{};
+    delivery.max_samples = UXR_MAX_SAMPLES_UNLIMITED;
+    delivery.max_elapsed_time = 0;
+    delivery.max_bytes_per_second = t.delivery.max_bytes_per_second;
+    delivery.min_pace_period = t.delivery.min_pace_ms;
+    return delivery;
+}
+
+void MiracDDS::requestTimeSync()
+{
+    // Zero timeout only sends the request, the reply shows up in a later
+    // spinOnce and goes through on_time
+    time_sync_sent_ms_ = uxr_millis();
+    last_time_syncd_time_ms_ = time_sync_sent_ms_;
+    (void)uxr_sync_session(&session_, 0);
+}
+
+void MiracDDS::on_time_entry(uxrSession *session, int64_t current_ns, int64_t transmit_ns, int64_t received_ns, int64_t originate_ns, void *args)
+{
+    (void)session;
+    MiracDDS *dds = (MiracDDS *)args;
+    dds->on_time(current_ns, transmit_ns, received_ns, originate_ns);
+}
+
+void MiracDDS::on_time(int64_t current_ns, int64_t transmit_ns, int64_t received_ns, int64_t originate_ns)
+{
+    // NTP style, t0 originate and t3 current are local, t1/t2 agent
+    const int64_t offset_ns = ((originate_ns + current_ns) - (received_ns + transmit_ns)) / 2;
+    const int64_t rtt_ns = (current_ns - originate_ns) - (transmit_ns - received_ns);
+    time_sync_sent_ms_ = 0;
+
+    if (!clock_.addSample(current_ns, offset_ns, rtt_ns))
+    {
+        ++session_stats_.time_syncs_rejected;
+        LOG_DBG("Time sync discarded, round-trip %" PRId64 " us", rtt_ns / 1000);
+        return;
+    }
+
+    // Keep uxr_epoch_nanos() users on the filtered clock too
+    session_.time_offset = clock_.offsetAt(current_ns);
+    ++session_stats_.time_syncs;
+    session_stats_.time_offset_ns = session_.time_offset;
+    session_stats_.time_drift_ppb = clock_.driftPpb();
+    LOG_DBG("Time synchronized. offset: %" PRId64 " us, round-trip %" PRId64 " us", offset_ns / 1000, rtt_ns / 1000);
+}
+
+int64_t MiracDDS::epochNanos() const
+{
+    const int64_t local_ns = uxr_nanos();
+    return local_ns - clock_.offsetAt(local_ns);
+}
+
+void MiracDDS::scheduleTopics()
+{
+    const int64_t now_ms = uxr_millis();
+    const size_t topics_count = sizeof(topics) / sizeof(topics[0]);
+
+    scheduler_.clear();
+    for (size_t i = 0; i < topics_count; ++i)
+    {
+        const uint32_t rate_ms = topicRate(i);
+        if (isActive(i) && topics[i].role_type == topicRole::TOPIC_ROLE_PUB && rate_ms > 0)
+        {
+            scheduler_.add(static_cast<uint8_t>(i), rate_ms, now_ms);
+        }
+    }
+}
+
+void MiracDDS::publishTopic(uint8_t index)
+{
+#if defined(CONFIG_MICROXRCEDDSCLIENT_DIAGNOSTICS)
+    if (index == to_underlying(TopicIndex::DIAGNOSTICS_PUB))
+    {
+        publishDiagnostics();
+        return;
+    }
+#endif
+
+#if CONFIG_MICROXRCEDDSCLIENT_LOAD_TOPICS > 0
+    if (index >= to_underlying(TopicIndex::LOAD_PUB_FIRST) && index <= to_underlying(TopicIndex::LOAD_PUB_LAST))
+    {
+        builtin_interfaces_msg_Time stamp;
+        updateTopic(&stamp);
+        (void)writeTopic(index, &stamp);
+        return;
+    }
+#endif
+
+    const streamSource &source = streams_[index];
+    if (source.serialize)
+    {
+        const uint32_t size = source.size(source.user);
+        if (size > 0)
+        {
+            (void)writeSerialized(index, size, [&](ucdrBuffer *ub)
+                                  { return source.serialize(ub, source.user); });
+        }
+        return;
+    }
+
+    SampleQueueBase *queue = publishers_[index];
+    if (!queue)
+    {
+        return;
+    }
+
+    // Everything queued since the last deadline goes out in order, the
+    // producer keeps filling freed slots while we serialize
+    const void *sample;
+    while ((sample = queue->front()) != nullptr)
+    {
+        (void)writeTopic(index, sample);
+        queue->pop();
+    }
+}
+
+void MiracDDS::publishDiagnostics()
+{
+#if defined(CONFIG_MICROXRCEDDSCLIENT_DIAGNOSTICS)
+    const size_t topics_count = sizeof(topics) / sizeof(topics[0]);
+    std_msgs_msg_String line;
+
+    // Skip topics without a line, the load topics sit on LOAD_PUB_FIRST
+    while (diagnostics_cursor_ >= 2 && diagnostics_cursor_ < topics_count + 2)
+    {
+        const size_t i = diagnostics_cursor_ - 2;
+#if CONFIG_MICROXRCEDDSCLIENT_LOAD_TOPICS > 0
+        if (i == to_underlying(TopicIndex::LOAD_PUB_FIRST))
+        {
+            break;
+        }
+        if (i > to_underlying(TopicIndex::LOAD_PUB_FIRST) && i <= to_underlying(TopicIndex::LOAD_PUB_LAST))
+        {
+            diagnostics_cursor_ = to_underlying(TopicIndex::LOAD_PUB_LAST) + 3;
+            continue;
+        }
+#endif
+        if (isDiagnosed(i))
+        {
+            break;
+        }
+        ++diagnostics_cursor_;
+    }
+    if (diagnostics_cursor_ >= topics_count + 2)
+    {
+        diagnostics_cursor_ = 0;
+    }
+
+    if (diagnostics_cursor_ == 0)
+    {
+        const sessionStats &s = session_stats_;
+        snprintf(line.data, sizeof(line.data),
+                 "session n=%u reused=%u spins=%u spin_max_us=%u overruns=%u pings_missed=%u offset_us=%" PRId64 " drift_ppb=%" PRId64 " syncs=%u/%u batch=%u/%u thr=%u",
+                 (unsigned)s.sessions, (unsigned)s.entities_reused, (unsigned)s.spins,
+                 (unsigned)k_cyc_to_us_floor32(s.spin_cycles_max), (unsigned)s.spin_overruns, (unsigned)s.pings_missed,
+                 s.time_offset_ns / 1000, s.time_drift_ppb,
+                 (unsigned)s.time_syncs, (unsigned)(s.time_syncs + s.time_syncs_rejected),
+                 (unsigned)s.flushed_samples, (unsigned)s.flushes, (unsigned)s.throttled);
+    }
+    else if (diagnostics_cursor_ == 1)
+    {
+        // CPU and ISR shares since the previous thread line, in permille
+        const threadStats usage = threadUsage();
+        const threadStats &last = last_thread_usage_;
+        const uint64_t cycles_all = usage.cycles_all - last.cycles_all;
+        const uint64_t isr_cycles = (uint32_t)(usage.isr_cycles_total - last.isr_cycles_total);
+        const unsigned cpu = cycles_all ? (unsigned)((usage.cycles - last.cycles) * 1000U / cycles_all) : 0U;
+        const unsigned isr = cycles_all ? (unsigned)(isr_cycles * 1000U / cycles_all) : 0U;
+
+        snprintf(line.data, sizeof(line.data),
+                 "thread prio=%d stack_used=%u/%u cpu_permille=%u isr=%u isr_max_us=%u isr_permille=%u tx_full=%u rx_drop=%u",
+                 k_thread_priority_get(const_cast<k_tid_t>(&thread_data_)),
+                 (unsigned)(usage.stack_size - usage.stack_unused), (unsigned)usage.stack_size,
+                 cpu, (unsigned)usage.isr_count, (unsigned)k_cyc_to_us_floor32(usage.isr_cycles_max), isr,
+                 (unsigned)usage.tx_full, (unsigned)usage.rx_dropped);
+        last_thread_usage_ = usage;
+    }
+#if CONFIG_MICROXRCEDDSCLIENT_LOAD_TOPICS > 0
+    else if (diagnostics_cursor_ - 2 == to_underlying(TopicIndex::LOAD_PUB_FIRST))
+    {
+        // Totals over the active load topics
+        topicStats sum{};
+        unsigned active = 0;
+        for (size_t i = to_underlying(TopicIndex::LOAD_PUB_FIRST); i <= to_underlying(TopicIndex::LOAD_PUB_LAST); ++i)
+        {
+            if (!isActive(i))
+            {
+                continue;
+            }
+            const topicStats &s = topic_stats_[i];
+            ++active;
+            sum.samples += s.samples;
+            sum.bytes += s.bytes;
+            sum.serialize_cycles_max = MAX(sum.serialize_cycles_max, s.serialize_cycles_max);
+            sum.stream_full += s.stream_full;
+            sum.fragmented += s.fragmented;
+        }
+
+        snprintf(line.data, sizeof(line.data), "load active=%u/%u n=%u bytes=%u ser_us_max=%u full=%u frag=%u",
+                 active, (unsigned)CONFIG_MICROXRCEDDSCLIENT_LOAD_TOPICS, (unsigned)sum.samples, (unsigned)sum.bytes,
+                 (unsigned)k_cyc_to_us_floor32(sum.serialize_cycles_max), (unsigned)sum.stream_full,
+                 (unsigned)sum.fragmented);
+        diagnostics_cursor_ = to_underlying(TopicIndex::LOAD_PUB_LAST) + 2;
+    }
+#endif
+    else
+    {
+        const size_t i = diagnostics_cursor_ - 2;
+        const topicList &t = topics[i];
+        const topicStats &s = topic_stats_[i];
+        const bool is_pub = (t.role_type == topicRole::TOPIC_ROLE_PUB);
+        const SampleQueueBase *queue = is_pub ? static_cast<const SampleQueueBase *>(publishers_[i])
+                                              : static_cast<const SampleQueueBase *>(readers_[i].queue);
+        const char *name = strrchr(t.topic_name, '/');
+
+        snprintf(line.data, sizeof(line.data),
+                 "%u %s %s n=%u bytes=%u ser_us=%u/%u full=%u err=%u drop=%u evict=%u frag=%u",
+                 (unsigned)i, name ? name + 1 : t.topic_name, is_pub ? "pub" : "sub",
+                 (unsigned)s.samples, (unsigned)s.bytes,
+                 (unsigned)k_cyc_to_us_floor32(s.serialize_cycles),
+                 (unsigned)k_cyc_to_us_floor32(s.serialize_cycles_max),
+                 (unsigned)s.stream_full, (unsigned)s.codec_errors,
+                 (unsigned)(queue ? queue->dropped() : 0),
+                 (unsigned)((!is_pub && readers_[i].queue) ? readers_[i].queue->evicted() : 0), (unsigned)s.fragmented);
+    }
+
+    diagnostics_cursor_ = (diagnostics_cursor_ + 1) % (topics_count + 2);
+    (void)writeTopic<DiagnosticsPub>(line);
+#endif
+}
+
+bool MiracDDS::writeTopic(uint8_t index, const void *sample)
+{
+    const msgType *type = topics[index].msg_type;
+    // Fixed-size types skip the size_of walk over the sample
+    if (type->fixed_size)
+    {
+        return writeSerialized(index, type->fixed_size, [&](ucdrBuffer *ub)
+                               { return type->serialize(ub, sample); });
+    }
+
+    // Strings are measured once, serialize reuses the lengths size_of found
+    uint32_t lengths[MSG_MAX_SIZED_LENGTHS];
+    const uint32_t topic_size = type->size_of_sized(sample, 0, lengths);
+    return writeSerialized(index, topic_size, [&](ucdrBuffer *ub)
+                           { return type->serialize_sized(ub, sample, lengths); });
+}
+
+template <typename SerializeFn>
+bool MiracDDS::writeSerialized(uint8_t index, uint32_t size, SerializeFn &&serialize)
 {
     if (!isConnected())
     {
         return false;
     }
 
+    const topicList &t = topics[index];
+    topicStats &stats = topic_stats_[index];
+    const uint32_t start = k_cycle_get_32();
+
+    // Larger samples are split over several reliable slots, every time
+    // the history fills up on_buffers_full waits for it to drain
+    const bool fragmented = (size > DDS_MTU - DDS_WRITE_OVERHEAD);
+    if (fragmented && t.qos.reliability == UXR_RELIABILITY_BEST_EFFORT)
+    {
+        ++stats.stream_full;
+        DDS_HOT_LOG_ERR("Sample of %u bytes exceeds the MTU of best-effort index '%u'.", (unsigned)size, (unsigned)index);
+        return false;
+    }
+
     ucdrBuffer ub{};
-    const uint32_t topic_size = std_msgs_msg_String_size_of_topic(&talker_topic_, 0);
-    if (!uxr_prepare_output_stream(
-            &session_, reliable_out_, topics[to_underlying(TopicIndex::TALKER_PUB)].data_entity_id, &ub, topic_size))
+    const uint16_t request = fragmented
+        ? uxr_prepare_output_stream_fragmented(&session_, outputStream(t), t.data_entity_id, &ub, size, MiracDDS::on_buffers_full)
+        : uxr_prepare_output_stream(&session_, outputStream(t), t.data_entity_id, &ub, size);
+    if (request == UXR_INVALID_REQUEST_ID)
     {
-        LOG_ERR("Failed to prepare output stream.");
+        // Out of stream slots, the link does not drain as fast as we publish
+        ++stats.stream_full;
+        DDS_HOT_LOG_ERR("Failed to prepare output stream for index '%u'.", (unsigned)index);
         return false;
     }
 
-    const bool ok = std_msgs_msg_String_serialize_topic(&ub, &talker_topic_);
+    const bool ok = serialize(&ub) && !ub.error;
     if (!ok)
     {
-        LOG_ERR("Failed to serialize std_msgs::String.");
+        // A fragmented write also fails here when the agent stopped acknowledging
+        ++stats.codec_errors;
+        DDS_HOT_LOG_ERR("Failed to serialize %s.", t.msg_type->type_name);
         return false;
     }
+
+    stats.serialize_cycles = k_cycle_get_32() - start;
+    stats.serialize_cycles_max = MAX(stats.serialize_cycles_max, stats.serialize_cycles);
+    ++stats.samples;
+    ++pending_samples_;
+    stats.bytes += size;
+    if (fragmented)
+    {
+        ++stats.fragmented;
+    }
     return true;
 }
 
+bool MiracDDS::on_buffers_full(uxrSession *session)
+{
+    // Send what the history holds and wait until the agent has
+    // acknowledged it, then serialization continues in the freed slots
+    return uxr_run_session_until_confirm_delivery(session, DDS_FRAGMENT_ACK_TIMEOUT_MS);
+}
+
 //---------------------------------------------------------------------
 // Private: data update helpers
 //---------------------------------------------------------------------
@@ -355,12 +1136,12 @@ void MiracDDS::updateTopic(std_msgs_msg_String *msg, const char *str)
     msg->data[sizeof(msg->data) - 1] = '\0';
 }
 
-void MiracDDS::updateTopic(builtin_interfaces_msg_Time *msg)
+void MiracDDS::updateTopic(builtin_interfaces_msg_Time *msg) const
 {
     if (!msg)
         return;
 
-    int64_t utc_nanos = uxr_epoch_nanos(&session_);
+    int64_t utc_nanos = epochNanos();
     msg->sec = static_cast<int32_t>(utc_nanos / 1000000000ULL);
     msg->nanosec = static_cast<uint32_t>(utc_nanos % 1000000000ULL);
 }
@@ -377,20 +1158,57 @@ void MiracDDS::on_topic(uxrSession *uxr_session, uxrObjectId object_id, uint16_t
     (void)uxr_session;
     (void)request_id;
     (void)stream_id;
-    (void)length;
 
-    switch (object_id.id)
+    // Entity ids equal their topics[] index, checked in mirac_dds_topic_list.h
+    const size_t index = object_id.id;
+    if (index >= sizeof(topics) / sizeof(topics[0]) || topics[index].role_type != topicRole::TOPIC_ROLE_SUB)
     {
-    case topics[to_underlying(TopicIndex::CHATTER_SUB)].data_entity_id.id:
+        return;
+    }
+
+    const topicList &t = topics[index];
+    const reader &r = readers_[index];
+    topicStats &stats = topic_stats_[index];
+    ++stats.samples;
+    stats.bytes += length;
+
+    if (r.queue)
     {
-        const bool success = std_msgs_msg_String_deserialize_topic(ub, &rx_chatter_topic_);
-        if (success == false)
+        // Zero-copy handoff, the consumer thread reads the slot in place
+        void *slot = r.queue->claimSlot();
+        if (!slot && !r.queue->dropsOldest())
         {
-            LOG_ERR("Failed to deserialize a String msg.");
-            break;
+            DDS_HOT_LOG_DBG("Subscribe queue of index '%u' full, sample dropped.", (unsigned)index);
+            return;
+        }
+        // A full DROP_OLDEST queue gives up its oldest sample only for a
+        // good one, decode aside first and copy it in
+        if (!t.msg_type->deserialize(ub, slot ? slot : &rx_sample_))
+        {
+            ++stats.codec_errors;
+            DDS_HOT_LOG_ERR("Failed to deserialize a %s msg.", t.msg_type->type_name);
+            return;
         }
-        LOG_INF("I heard: %s", rx_chatter_topic_.data);
-        break;
+        if (slot)
+        {
+            r.queue->deliver();
+        }
+        else if (!r.queue->replaceOldest(&rx_sample_))
+        {
+            DDS_HOT_LOG_DBG("Subscribe queue of index '%u' full, sample dropped.", (unsigned)index);
+        }
+        return;
     }
+
+    if (!r.invoke)
+    {
+        return;
+    }
+    if (!t.msg_type->deserialize(ub, &rx_sample_))
+    {
+        ++stats.codec_errors;
+        DDS_HOT_LOG_ERR("Failed to deserialize a %s msg.", t.msg_type->type_name);
+        return;
     }
+    r.invoke(r, &rx_sample_);
 }
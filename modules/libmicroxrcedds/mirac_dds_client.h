@@ -8,10 +8,12 @@
 #include <cstddef>
 #include <string.h>
 #include <uxr/client/client.h>
-#include "builtin_interfaces/msg/Time.h"
-#include "std_msgs/msg/String.h"
+#include "microxrce_transports.h"
+#include "mirac_dds_msg_types.h"
+#include "mirac_dds_sample_queue.h"
+#include "mirac_dds_scheduler.h"
+#include "mirac_dds_clock.h"
 
-#define ROS_DDS_MSG_TYPE_NAME(pkg, type) pkg "::msg::dds_::" type "_"
 #define ROS_DDS_TOPIC_NAME(topic) "rt" topic
 #define ROS_DDS_TOPIC_NAMESPACE(namespace, topic) ROS_DDS_TOPIC_NAME("/" namespace "/" topic)
 
@@ -21,19 +23,68 @@
 #define DEBUG_MSG_PREFIX_WARN DEBUG_MSG_PREFIX("WARNING")
 #define DEBUG_MSG_PREFIX_ERROR DEBUG_MSG_PREFIX("ERROR")
 
+class MiracDDSLink;
+
 class MiracDDS
 {
 public:
-    // This will config in Kconfig
-    inline static constexpr uint16_t DDS_STREAM_HISTORY = 20;
-    inline static constexpr size_t DDS_BUFFER_SIZE = UXR_CONFIG_CUSTOM_TRANSPORT_MTU * DDS_STREAM_HISTORY;
+    inline static constexpr size_t DDS_MTU = CONFIG_MICROXRCEDDSCLIENT_XRCE_DDS_MTU;
+    inline static constexpr uint16_t DDS_OUTPUT_RELIABLE_HISTORY = CONFIG_MICROXRCEDDSCLIENT_OUTPUT_RELIABLE_HISTORY;
+    inline static constexpr uint16_t DDS_INPUT_RELIABLE_HISTORY = CONFIG_MICROXRCEDDSCLIENT_INPUT_RELIABLE_HISTORY;
+    inline static constexpr size_t DDS_OUTPUT_RELIABLE_BUFFER_SIZE = DDS_MTU * DDS_OUTPUT_RELIABLE_HISTORY;
+    inline static constexpr size_t DDS_INPUT_RELIABLE_BUFFER_SIZE = DDS_MTU * DDS_INPUT_RELIABLE_HISTORY;
+    // Best-effort streams keep no history, one message is built at a time
+    inline static constexpr size_t DDS_OUTPUT_BEST_EFFORT_BUFFER_SIZE = DDS_MTU;
+#if defined(CONFIG_MICROXRCEDDSCLIENT_CONTROL_STREAM)
+    inline static constexpr uint16_t DDS_CONTROL_OUTPUT_HISTORY = CONFIG_MICROXRCEDDSCLIENT_CONTROL_OUTPUT_RELIABLE_HISTORY;
+    inline static constexpr size_t DDS_CONTROL_OUTPUT_BUFFER_SIZE = DDS_MTU * DDS_CONTROL_OUTPUT_HISTORY;
+#else
+    inline static constexpr size_t DDS_CONTROL_OUTPUT_BUFFER_SIZE = 0;
+#endif
+    // Static stream buffers of one instance, also printed by CMake
+    inline static constexpr size_t DDS_STREAM_RAM = DDS_OUTPUT_RELIABLE_BUFFER_SIZE + DDS_INPUT_RELIABLE_BUFFER_SIZE +
+                                                    DDS_OUTPUT_BEST_EFFORT_BUFFER_SIZE + DDS_CONTROL_OUTPUT_BUFFER_SIZE;
+    // Message header with client key, submessage header and WRITE_DATA
+    // object request, what a sample shares an MTU with
+    inline static constexpr size_t DDS_WRITE_OVERHEAD = 8 + 4 + 4;
     inline static constexpr int DDS_REQ_TIMEOUT_MS = 500;
+    // Wait for acknowledgements once a fragmented sample fills the history
+    inline static constexpr int DDS_FRAGMENT_ACK_TIMEOUT_MS = DDS_REQ_TIMEOUT_MS;
     inline static constexpr uint32_t ROS_DOMAIN_ID = 0; // DDS domain ID
     // Maximum number of attempts to ping the XRCE agent before exiting
     inline static constexpr uint8_t DDS_PING_MAX_RETRY = 10;
     // Timeout in milliseconds when pinging the XRCE agent
     inline static constexpr int DDS_PING_TIMEOUT_MS = 1000;
+    // Pause before pinging again after the session could not be set up
+    inline static constexpr int DDS_SESSION_RETRY_DELAY_MS = 1000;
+    // Quiet time on the link before the agent is pinged
+    inline static constexpr int DDS_PING_INTERVAL_MS = CONFIG_MICROXRCEDDSCLIENT_PING_INTERVAL_MS;
+    // Unanswered pings in a row before the session is considered lost
+    inline static constexpr size_t DDS_PING_MISS_THRESHOLD = CONFIG_MICROXRCEDDSCLIENT_PING_MISS_THRESHOLD;
     inline static constexpr uint16_t DDS_PARTICIPANT_ID = 0x01;
+    // Client key of an instance that doesn't configure its own
+    inline static constexpr uint32_t DDS_CLIENT_KEY = 0xAAAABBBB;
+    // Periodic publishers due this soon go out with the current pass
+    inline static constexpr uint32_t DDS_BATCH_WINDOW_MS = CONFIG_MICROXRCEDDSCLIENT_BATCH_WINDOW_MS;
+    // Telemetry held back this long after the transport cut a write short
+    inline static constexpr uint32_t DDS_TELEMETRY_BACKOFF_MS = CONFIG_MICROXRCEDDSCLIENT_TELEMETRY_BACKOFF_MS;
+    // Upper bound of entries in topics[], sizes the per-topic tables
+    inline static constexpr size_t DDS_MAX_TOPICS = CONFIG_MICROXRCEDDSCLIENT_MAX_TOPICS;
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_CREATE_ENTITIES_BY_REF)
+    // Create entities from profiles in the agent reference file
+    inline static constexpr bool DDS_CREATE_BY_REF = true;
+#else
+    inline static constexpr bool DDS_CREATE_BY_REF = false;
+#endif
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_SESSION_RESUME)
+    // Keep agent entities that match ours, replace only the mismatched
+    // ones, so a reconnect doesn't recreate the DDS writers and readers
+    inline static constexpr uint8_t DDS_CREATE_FLAGS = UXR_REUSE | UXR_REPLACE;
+#else
+    inline static constexpr uint8_t DDS_CREATE_FLAGS = UXR_REPLACE;
+#endif
 
 #if defined(CONFIG_MICROXRCEDDSCLIENT_PARTICIPANT_NAME)
     inline static constexpr const char *DDS_PARTICIPANT_NAME = CONFIG_MICROXRCEDDSCLIENT_PARTICIPANT_NAME;
@@ -42,7 +93,22 @@ public:
 #endif
 
 public:
+    // Per-instance settings, the defaults give the single instance the
+    // Kconfig options describe
+    struct config
+    {
+        uint32_t client_key = DDS_CLIENT_KEY; // Unique per instance
+        uint8_t session = 0;                  // Serves the topics[] entries with this .session
+        const char *participant_name = DDS_PARTICIPANT_NAME;
+        const char *thread_name = "mirac_dds";
+        int thread_priority = CONFIG_MICROXRCEDDSCLIENT_THREAD_PRIORITY;
+        k_thread_stack_t *stack = nullptr;    // nullptr for the Kconfig sized built-in stack
+        size_t stack_size = 0;                // K_THREAD_STACK_SIZEOF(stack)
+        MiracDDSLink *link = nullptr;         // Shared transport, nullptr to open our own
+    };
+
     MiracDDS();
+    explicit MiracDDS(const config &cfg);
     ~MiracDDS();
 
     // Start DDS thread
@@ -66,12 +132,185 @@ public:
     // Update internal data and publish
     void update();
 
+    // Milliseconds until the next scheduled publisher or time sync is due
+    int nextDeadlineMs() const;
+
     // Check connection status
     bool isConnected() const;
 
+    // Register the handler called from the DDS thread for every sample
+    // received on a subscriber topic, call before startThread()
+    template <typename T>
+    bool subscribe(void (*handler)(const typename T::msg_type *sample, void *user), void *user = nullptr)
+    {
+        static_assert(T::role == topicRole::TOPIC_ROLE_SUB, "subscribe() needs a subscriber topic");
+        reader &r = readers_[T::index];
+        r.invoke = invokeReader<typename T::msg_type>;
+        r.handler = reinterpret_cast<void (*)()>(handler);
+        r.user = user;
+        r.queue = nullptr;
+        return true;
+    }
+
+    // Hand samples of a subscriber topic to an application thread instead,
+    // they are deserialized straight into a free queue slot and consumed in
+    // place with queue.receive()/release(); call before startThread().
+    // A full queue follows the topics[] entry's .overflow policy.
+    template <typename T, uint32_t Depth>
+    bool subscribe(SubscribeQueue<typename T::msg_type, Depth> &queue)
+    {
+        static_assert(T::role == topicRole::TOPIC_ROLE_SUB, "subscribe() needs a subscriber topic");
+        queue.setOverflow(topics[T::index].overflow);
+        reader &r = readers_[T::index];
+        r.invoke = nullptr;
+        r.handler = nullptr;
+        r.user = nullptr;
+        r.queue = &queue;
+        return true;
+    }
+
+    // Register the queue an application thread fills for a publisher
+    // topic, the DDS thread drains and serializes it; call before startThread()
+    template <typename T, uint32_t Depth>
+    bool advertise(PublishQueue<typename T::msg_type, Depth> &queue)
+    {
+        static_assert(T::role == topicRole::TOPIC_ROLE_PUB, "advertise() needs a publisher topic");
+        publishers_[T::index] = &queue;
+        streams_[T::index] = {};
+        return true;
+    }
+
+    // Producer of samples too large to keep as a generated struct, the DDS
+    // thread calls it whenever the topic is due
+    struct streamSource
+    {
+        // CDR size of the next sample, 0 when none is ready
+        uint32_t (*size)(void *user);
+        // Write exactly size() bytes of CDR in as many pieces as convenient,
+        // the reliable history is sent and reused as it fills up
+        bool (*serialize)(ucdrBuffer *ub, void *user);
+        void *user;
+    };
+
+    // Publish a reliable topic straight from a streamSource instead of a
+    // queue, the sample is never held in RAM as a whole; call before startThread()
+    template <typename T>
+    bool advertise(const streamSource &source)
+    {
+        static_assert(T::role == topicRole::TOPIC_ROLE_PUB, "advertise() needs a publisher topic");
+        static_assert(topics[T::index].qos.reliability == UXR_RELIABILITY_RELIABLE,
+                      "Only reliable topics can be fragmented");
+        publishers_[T::index] = nullptr;
+        streams_[T::index] = source;
+        return true;
+    }
+
     // Clean up resources
     void cleanup();
 
+    // Counters of one topics[] entry, written by the DDS thread only
+    struct topicStats
+    {
+        uint32_t samples;              // Samples published or received
+        uint32_t bytes;                // Serialized payload bytes
+        uint32_t serialize_cycles;     // Last prepare+serialize in k_cycle_get_32() cycles
+        uint32_t serialize_cycles_max; // Slowest prepare+serialize
+        uint32_t stream_full;          // uxr_prepare_output_stream failures
+        uint32_t fragmented;           // Samples larger than one stream slot
+        uint32_t codec_errors;         // (De)serialization failures
+    };
+
+    struct sessionStats
+    {
+        uint32_t sessions;             // Sessions created since boot
+        uint32_t spins;                // spinOnce calls
+        uint32_t spin_cycles_max;      // Longest spinOnce in k_cycle_get_32() cycles
+        uint32_t spin_overruns;        // spinOnce calls returning over 1 ms past their timeout
+        uint32_t pings_missed;         // Agent pings without reply
+        uint32_t entities_reused;      // Entities of the last session already held by the agent
+        int64_t time_offset_ns;        // Filtered offset after the last time sync
+        int64_t time_drift_ppb;        // Estimated local clock drift against the agent
+        uint32_t time_syncs;           // Time sync replies applied
+        uint32_t time_syncs_rejected;  // Replies discarded for their round-trip
+        uint32_t flushes;              // update() passes that sent samples
+        uint32_t flushed_samples;      // Samples sent by those passes
+        uint32_t throttled;            // update() passes that held telemetry back for backpressure
+    };
+
+    // Resource usage of the DDS thread, cumulative since boot
+    struct threadStats
+    {
+        size_t stack_size;
+        size_t stack_unused;           // Stack never touched so far, needs CONFIG_INIT_STACKS
+        uint64_t cycles;               // Cycles run by the DDS thread
+        uint64_t cycles_all;           // Cycles run by all threads including idle
+        uint32_t isr_count;            // Transport interrupt/driver callbacks
+        uint32_t isr_cycles_max;       // Longest of them
+        uint32_t isr_cycles_total;
+        uint32_t tx_full;              // Transport writes cut short by a full link
+        uint32_t rx_dropped;           // Received bytes the transport had no room for
+    };
+
+    // Safe to call from any thread, fields the kernel doesn't track stay 0
+    threadStats threadUsage() const;
+
+    const topicStats &stats(uint8_t index) const
+    {
+        return topic_stats_[index];
+    }
+
+    const sessionStats &stats() const
+    {
+        return session_stats_;
+    }
+
+    // Data update methods
+    static void updateTopic(std_msgs_msg_String *msg, const char *str);
+
+    // Stamp with the filtered agent clock, safe from any thread
+    void updateTopic(builtin_interfaces_msg_Time *msg) const;
+
+    // Agent epoch time in ns, monotonic between syncs, safe from any thread
+    int64_t epochNanos() const;
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS)
+    // Runtime overrides of the topics[] table, shared by all instances and
+    // applied by each DDS thread on its next pass; safe from any thread
+    inline static constexpr uint32_t RATE_DEFAULT = UINT32_MAX;
+
+    static bool setTopicEnabled(size_t index, bool enabled);
+
+    // Publish period in ms, 0 for every pass, RATE_DEFAULT for topics[].rate_limit.
+    // False for subscribers, and for 0 on topics MiracDDS fills itself
+    // (diagnostics, load topics) which only publish on a deadline
+    static bool setTopicRate(size_t index, uint32_t rate_ms);
+
+    static bool topicEnabled(size_t index);
+
+    // Effective publish period of a publisher topic
+    static uint32_t topicRate(size_t index);
+
+    // topics[] index of a full or last component topic name, -1 if none
+    static int findTopic(const char *name);
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS_SETTINGS)
+    // Store the current overrides under miracdds/topic, settings_load()
+    // before startThread() brings them back
+    static int saveTopicConfig();
+#endif
+#else
+    static bool topicEnabled(size_t index)
+    {
+        (void)index;
+        return true;
+    }
+
+    static uint32_t topicRate(size_t index)
+    {
+        return topics[index].rate_limit;
+    }
+#endif
+
 public:
     enum class topicRole : uint8_t
     {
@@ -79,6 +318,20 @@ public:
         TOPIC_ROLE_SUB = 1,
     };
 
+    enum class topicPriority : uint8_t
+    {
+        PRIORITY_TELEMETRY = 0, // Default, held back under transport backpressure
+        PRIORITY_CONTROL = 1,   // Written first, own reliable stream with CONFIG_MICROXRCEDDSCLIENT_CONTROL_STREAM
+    };
+
+    // Agent-side pacing of a subscriber topic, what the agent holds back
+    // never reaches the MCU; 0 for no limit
+    struct deliveryLimit
+    {
+        uint16_t min_pace_ms;          // Shortest gap between two samples, 1000 / max rate in Hz
+        uint16_t max_bytes_per_second; // Payload budget of the topic
+    };
+
     struct topicList
     {
         const uxrObjectId topic_id;       // DDS topic ID
@@ -86,52 +339,252 @@ public:
         const uxrObjectId role_id;        // Publisher/Subscriver ID
         const uxrObjectId data_entity_id; // Data writer/reader ID
         const char *topic_name;           // DDS Topic name
-        const char *type_name;            // Message type
-        const uint32_t rate_limit;        // Rate limit
+        const msgType *msg_type;          // Message type, &msgTraits<MsgT>::descriptor
+        const uint32_t rate_limit;        // Publish period in ms, 0 for not scheduled
         const uxrQoS_t qos;               // QoS
+        const char *profile_ref;          // Agent reference profile, nullptr to create from type_name/qos
+        const uint8_t session;            // config::session of the instance serving it, 0 by default
+        const topicPriority priority;     // Output class, telemetry by default
+        const deliveryLimit delivery;     // Subscribers only, unlimited by default
+        const QueueOverflow overflow;     // Full SubscribeQueue policy, drop the newest by default
     };
     static const topicList topics[]; // Custom topic list
 
+    // Compile-time handle of one topics[] entry, checked against the table
+    template <typename MsgT, topicRole Role, auto Index>
+    struct Topic
+    {
+        using msg_type = MsgT;
+        inline static constexpr topicRole role = Role;
+        inline static constexpr uint8_t index = static_cast<uint8_t>(Index);
+
+        static_assert(topics[index].role_type == Role, "Topic role does not match topics[]");
+        static_assert(topics[index].msg_type == &msgTraits<MsgT>::descriptor,
+                      "Topic message type does not match topics[]");
+    };
+
 private:
+    // Create requests buffered on the reliable stream and waited on as one batch
+    struct createBatch
+    {
+        // Participant plus topic/role/data entity of up to 32 topics, larger
+        // tables are pipelined in several windows to bound the stack usage
+        inline static constexpr size_t CAPACITY = 1 + 3 * ((DDS_MAX_TOPICS < 32) ? DDS_MAX_TOPICS : 32);
+        uint16_t requests[CAPACITY];
+        uint8_t status[CAPACITY];
+        const char *entity[CAPACITY];
+        int16_t topic_index[CAPACITY];
+        size_t count;
+        size_t total;  // Requests waited on so far
+        size_t reused; // Of those, entities the agent already had (UXR_STATUS_OK_MATCHED)
+    };
+
+    // Custom transport args, the transport params come first so the
+    // transport callbacks can keep casting args to their params
+    struct transportArgs
+    {
+        zephyr_transport_params_t params;
+        int64_t last_rx_ms; // Last time anything arrived from the agent
+        MiracDDSLink *link; // Shared transport, nullptr when params are used
+        uint8_t port;       // Our port on the link
+    };
+
+    // zephyr_transport_read that also stamps transportArgs::last_rx_ms
+    static size_t transport_read(uxrCustomTransport *transport, uint8_t *buf, size_t len, int timeout, uint8_t *err);
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_SHARED_LINK)
+    // Unframed custom transport over our port of the shared link
+    static bool link_open(uxrCustomTransport *transport);
+    static bool link_close(uxrCustomTransport *transport);
+    static size_t link_write(uxrCustomTransport *transport, const uint8_t *buf, size_t len, uint8_t *err);
+    static size_t link_read(uxrCustomTransport *transport, uint8_t *buf, size_t len, int timeout, uint8_t *err);
+#endif
+
+    // Whether topics[index] belongs to this instance
+    bool serves(size_t index) const
+    {
+        return topics[index].session == config_.session;
+    }
+
+    // Topics of this instance currently published or read
+    bool isActive(size_t index) const
+    {
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS)
+        return serves(index) && active_[index];
+#else
+        return serves(index);
+#endif
+    }
+
+    // Buffer one create request. If the reliable stream is out of slots,
+    // wait for the requests already in flight and try once more.
+    template <typename CreateFn>
+    bool bufferCreate(createBatch &batch, const char *entity, int16_t index, CreateFn &&create);
+
+    // Buffer the topic, publisher/subscriber and data entity of topics[index]
+    bool bufferTopicEntities(createBatch &batch, size_t index);
+
+    // Wait for every request in the batch, report each failed entity and reset it
+    static bool waitCreateBatch(uxrSession *session, createBatch &batch);
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS)
+    // Bumped by every override change
+    static uint32_t topicConfigVersion();
+
+    // Create newly enabled topics, start or stop readers and re-arm the scheduler
+    void applyTopicConfig();
+#endif
+
     static void on_topic_entry(uxrSession *uxr_session, uxrObjectId object_id, uint16_t request_id, uxrStreamId stream_id, struct ucdrBuffer *ub, uint16_t length, void *args);
     void on_topic(uxrSession* session, uxrObjectId object_id, uint16_t request_id, uxrStreamId stream_id, struct ucdrBuffer* ub, uint16_t length);
 
+    // Publishers without a rate limit, written on every pass
+    bool isUnscheduled(size_t index) const
+    {
+        return topicRate(index) == 0 && (publishers_[index] || streams_[index].serialize) && isActive(index);
+    }
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_DIAGNOSTICS)
+    // Topics with a line of their own: active and fed by a queue, stream or
+    // handler; the rest would only ever show zeros
+    bool isDiagnosed(size_t index) const
+    {
+        return isActive(index) &&
+               (publishers_[index] || streams_[index].serialize || readers_[index].queue || readers_[index].invoke);
+    }
+#endif
+
+    // Whether telemetry is held back after transport backpressure
+    bool telemetryThrottled(int64_t now_ms);
+
+    // Streams serving a topic according to its QoS reliability
+    uxrStreamId outputStream(const topicList &t) const;
+    uxrStreamId inputStream(const topicList &t) const;
+
+    // Read request parameters of a subscriber topic
+    static uxrDeliveryControl deliveryControl(const topicList &t);
+
+    // Send a time sync request, the reply is applied in on_time
+    void requestTimeSync();
+
+    static void on_time_entry(uxrSession *session, int64_t current_ns, int64_t transmit_ns, int64_t received_ns, int64_t originate_ns, void *args);
+    void on_time(int64_t current_ns, int64_t transmit_ns, int64_t received_ns, int64_t originate_ns);
+
+    // (Re)arm the publish deadlines of all periodic topics
+    void scheduleTopics();
+
+    // Drain the publish queue of one topic into its output stream
+    void publishTopic(uint8_t index);
+
+    // Publish the next line of counters on the diagnostics topic
+    void publishDiagnostics();
+
     // Topic publishing methods
-    bool writeTopicTalker();
+    bool writeTopic(uint8_t index, const void *sample);
 
-    // Data update methods
-    static void updateTopic(std_msgs_msg_String *msg, const char *str);
-    void updateTopic(builtin_interfaces_msg_Time *msg);
+    // Prepare the output stream for size bytes and run serialize(&ub) on
+    // it, fragmenting over the reliable history when one slot is too small
+    template <typename SerializeFn>
+    bool writeSerialized(uint8_t index, uint32_t size, SerializeFn &&serialize);
 
-private:
-    uxrSession session_;
+    // Flush callback of fragmented writes, frees history slots
+    static bool on_buffers_full(uxrSession *session);
 
-    // client key we present
-    static constexpr uint32_t client_key = 0xAAAABBBB;
+    template <typename T>
+    bool writeTopic(const typename T::msg_type &sample)
+    {
+        static_assert(T::role == topicRole::TOPIC_ROLE_PUB, "writeTopic() needs a publisher topic");
+        return writeTopic(T::index, &sample);
+    }
 
-    // delivery control params
-    uxrDeliveryControl delivery_control{
-        UXR_MAX_SAMPLES_UNLIMITED, // max_samples
-        0,                         // max_elapsed_time
-        0,                         // max_bytes_per_second
-        0                          // min_pace_period
+    // Subscriber handler or queue registered through subscribe()
+    struct reader
+    {
+        void (*invoke)(const reader &r, const void *sample);
+        void (*handler)(); // Typed handler, cast back by invoke
+        void *user;
+        SubscribeQueueBase *queue;
     };
 
+    template <typename MsgT>
+    static void invokeReader(const reader &r, const void *sample)
+    {
+        reinterpret_cast<void (*)(const MsgT *, void *)>(r.handler)(static_cast<const MsgT *>(sample), r.user);
+    }
+
+
+private:
+    const config config_;
+    struct k_thread thread_data_;
+    size_t stack_size_{0};
+
+    uxrSession session_;
+
     uxrCustomTransport transport_;
+    transportArgs transport_args_;
     bool is_status_ok_{false};
     bool is_connected_{false};
 
     uxrStreamId reliable_out_;
     uxrStreamId reliable_in_;
-    uint8_t output_buffer_[DDS_BUFFER_SIZE] __aligned(4);
-    uint8_t input_buffer_[DDS_BUFFER_SIZE] __aligned(4);
+    uint8_t output_buffer_[DDS_OUTPUT_RELIABLE_BUFFER_SIZE] __aligned(4);
+    uint8_t input_buffer_[DDS_INPUT_RELIABLE_BUFFER_SIZE] __aligned(4);
+
+    // Fire-and-forget lane for UXR_RELIABILITY_BEST_EFFORT topics,
+    // no acknowledgement or history so a lost packet stalls nothing
+    uxrStreamId best_effort_out_;
+    uxrStreamId best_effort_in_;
+    uint8_t best_effort_output_buffer_[DDS_OUTPUT_BEST_EFFORT_BUFFER_SIZE] __aligned(4);
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_CONTROL_STREAM)
+    // PRIORITY_CONTROL lane, its history never fills up with telemetry
+    uxrStreamId control_out_;
+    uint8_t control_output_buffer_[DDS_CONTROL_OUTPUT_BUFFER_SIZE] __aligned(4);
+#endif
 
     int64_t last_time_syncd_time_ms_{0};
+    int64_t time_sync_sent_ms_{0}; // Request in flight since, 0 if none
+    SyncedClock clock_;
+
+    DeadlineScheduler<DDS_MAX_TOPICS> scheduler_;
 
-    std_msgs_msg_String talker_topic_;
-    int64_t last_talker_time_ms_{0};
+    SampleQueueBase *publishers_[DDS_MAX_TOPICS];
+    streamSource streams_[DDS_MAX_TOPICS];
+    reader readers_[DDS_MAX_TOPICS];
+    msgSample rx_sample_; // Deserialization target of on_topic for handlers
 
-    std_msgs_msg_String rx_chatter_topic_;
+    topicStats topic_stats_[DDS_MAX_TOPICS];
+    sessionStats session_stats_;
+    uint32_t pending_samples_{0};  // Written since the last flush in update()
+    uint8_t due_telemetry_[DDS_MAX_TOPICS]; // Due this pass, published after the control topics
+    uint32_t last_tx_full_{0};      // Transport tx_full seen by the last pass
+    int64_t telemetry_resume_ms_{0}; // Telemetry held back until then
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS)
+    uint32_t topic_config_version_{0}; // Overrides applied so far
+    bool created_[DDS_MAX_TOPICS];     // Entities created in this session
+    bool active_[DDS_MAX_TOPICS];      // Created and enabled, readers requested
+#endif
+    // Next line, 0 for the session line, 1 for the thread line, then the
+    // topics[] index plus 2; the load topics share the line of the first
+    size_t diagnostics_cursor_{0};
+    threadStats last_thread_usage_{}; // Previous thread line, for the CPU share in between
 };
 
+// Reliable sequence numbers wrap at 2^16, slot = seq % history must stay
+// continuous across the wrap
+static_assert((MiracDDS::DDS_OUTPUT_RELIABLE_HISTORY & (MiracDDS::DDS_OUTPUT_RELIABLE_HISTORY - 1)) == 0,
+              "CONFIG_MICROXRCEDDSCLIENT_OUTPUT_RELIABLE_HISTORY must be a power of two");
+static_assert((MiracDDS::DDS_INPUT_RELIABLE_HISTORY & (MiracDDS::DDS_INPUT_RELIABLE_HISTORY - 1)) == 0,
+              "CONFIG_MICROXRCEDDSCLIENT_INPUT_RELIABLE_HISTORY must be a power of two");
+#if defined(CONFIG_MICROXRCEDDSCLIENT_CONTROL_STREAM)
+static_assert((MiracDDS::DDS_CONTROL_OUTPUT_HISTORY & (MiracDDS::DDS_CONTROL_OUTPUT_HISTORY - 1)) == 0,
+              "CONFIG_MICROXRCEDDSCLIENT_CONTROL_OUTPUT_RELIABLE_HISTORY must be a power of two");
+static_assert(UXR_CONFIG_MAX_OUTPUT_RELIABLE_STREAMS >= 2,
+              "Micro XRCE-DDS Client library was built with one reliable output stream, rebuild it");
+#endif
+static_assert(MiracDDS::DDS_MTU == UXR_CONFIG_CUSTOM_TRANSPORT_MTU,
+              "Micro XRCE-DDS Client library was built with a different MTU, rebuild it");
+static_assert(MiracDDS::DDS_MTU > MiracDDS::DDS_WRITE_OVERHEAD,
+              "CONFIG_MICROXRCEDDSCLIENT_XRCE_DDS_MTU leaves no room for samples");
+
 #endif // MIRAC_DDS_CLIENT_H_
\ No newline at end of file
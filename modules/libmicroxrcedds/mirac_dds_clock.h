@@ -0,0 +1,153 @@
+// Copyright (c) 2025, Cody Gu <gujiaqi@iscas.ac.cn>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MIRAC_DDS_CLOCK_H_
+#define MIRAC_DDS_CLOCK_H_
+
+#include <cstdint>
+#include <zephyr/sys/atomic.h>
+
+// Filtered offset between the local clock and the agent epoch clock,
+// offset = local - epoch as in uxrSession::time_offset.
+//
+// Samples with a round-trip far above the best one seen are discarded,
+// corrections below STEP_NS are slewed in over the slew window and the
+// clock drift is tracked, so epoch stamps stay monotonic between syncs.
+// Fed by the DDS thread only, offsetAt() may be called from any thread.
+class SyncedClock
+{
+public:
+    // Larger corrections are applied at once instead of slewed
+    inline static constexpr int64_t STEP_NS = 100LL * 1000 * 1000;
+    // Plausible crystal drift bound
+    inline static constexpr int64_t MAX_DRIFT_PPB = 500LL * 1000;
+    // Round-trip margin over the best seen before a sample is discarded
+    inline static constexpr int64_t RTT_MARGIN_NS = 2LL * 1000 * 1000;
+    // Consecutive discarded samples after which the next one is trusted
+    inline static constexpr uint8_t MAX_REJECTED = 3;
+
+    explicit SyncedClock(int64_t slew_window_ns) : slew_window_ns_{slew_window_ns} {}
+
+    bool synchronized() const
+    {
+        return load().valid;
+    }
+
+    // DDS thread: add one measured offset, false if it was discarded
+    bool addSample(int64_t local_ns, int64_t offset_ns, int64_t rtt_ns)
+    {
+        const model cur = load();
+
+        if (cur.valid && rtt_ns > 2 * min_rtt_ns_ + RTT_MARGIN_NS && rejected_ < MAX_REJECTED)
+        {
+            ++rejected_;
+            return false;
+        }
+        if (!cur.valid || rejected_ >= MAX_REJECTED || rtt_ns < min_rtt_ns_)
+        {
+            min_rtt_ns_ = rtt_ns;
+        }
+        rejected_ = 0;
+
+        const int64_t predicted_ns = evaluate(cur, local_ns);
+        const int64_t error_ns = offset_ns - predicted_ns;
+        model next{};
+        next.valid = true;
+        next.base_ns = local_ns;
+
+        if (!cur.valid || error_ns > STEP_NS || error_ns < -STEP_NS)
+        {
+            // First sync or the agent clock jumped
+            next.base_offset_ns = offset_ns;
+            next.drift_ppb = cur.valid ? cur.drift_ppb : 0;
+        }
+        else
+        {
+            // Integrate the residual into the drift estimate and slew it out
+            int64_t drift_ppb = cur.drift_ppb;
+            const int64_t since_ns = local_ns - last_sample_ns_;
+            if (since_ns > 0)
+            {
+                drift_ppb += error_ns * 1000000000LL / since_ns / 4;
+            }
+            next.drift_ppb = (drift_ppb > MAX_DRIFT_PPB) ? MAX_DRIFT_PPB
+                           : (drift_ppb < -MAX_DRIFT_PPB) ? -MAX_DRIFT_PPB : drift_ppb;
+            next.base_offset_ns = predicted_ns;
+            next.slew_ns = error_ns;
+        }
+
+        last_sample_ns_ = local_ns;
+        store(next);
+        return true;
+    }
+
+    // Any thread: filtered offset at local_ns, 0 until the first sample
+    int64_t offsetAt(int64_t local_ns) const
+    {
+        return evaluate(load(), local_ns);
+    }
+
+    // Current drift estimate of the local clock against the agent
+    int64_t driftPpb() const
+    {
+        return load().drift_ppb;
+    }
+
+private:
+    struct model
+    {
+        int64_t base_ns;        // Local time the model was computed at
+        int64_t base_offset_ns; // Offset at base_ns
+        int64_t drift_ppb;      // Offset change rate
+        int64_t slew_ns;        // Correction spread over the slew window
+        bool valid;
+    };
+
+    int64_t evaluate(const model &m, int64_t local_ns) const
+    {
+        if (!m.valid)
+        {
+            return 0;
+        }
+
+        const int64_t dt_ns = local_ns - m.base_ns;
+        // Split in us * ppm so hours without a sync don't overflow
+        const int64_t drift_ns = (dt_ns / 1000) * m.drift_ppb / 1000000;
+        const int64_t slew_ns = (dt_ns >= slew_window_ns_) ? m.slew_ns
+                              : (dt_ns <= 0) ? 0 : m.slew_ns * (dt_ns / 1000) / (slew_window_ns_ / 1000);
+        return m.base_offset_ns + drift_ns + slew_ns;
+    }
+
+    // Two slots and a version, the writer fills the slot readers don't
+    // use and readers retry when a publish overlapped their copy. Readers
+    // never wait for the writer, so priorities can't invert.
+    model load() const
+    {
+        model m;
+        atomic_val_t version;
+        do
+        {
+            version = atomic_get(&version_);
+            m = slots_[version & 1];
+        } while (atomic_get(&version_) != version);
+        return m;
+    }
+
+    void store(const model &m)
+    {
+        const atomic_val_t next = atomic_get(&version_) + 1;
+        slots_[next & 1] = m;
+        atomic_set(&version_, next);
+    }
+
+    model slots_[2]{};
+    atomic_t version_{ATOMIC_INIT(0)};
+
+    // Filter state, DDS thread only
+    int64_t last_sample_ns_{0};
+    int64_t min_rtt_ns_{0};
+    uint8_t rejected_{0};
+    const int64_t slew_window_ns_;
+};
+
+#endif // MIRAC_DDS_CLOCK_H_
@@ -0,0 +1,197 @@
+// Copyright (c) 2025, Cody Gu <gujiaqi@iscas.ac.cn>
+// SPDX-License-Identifier: Apache-2.0
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <zephyr/logging/log.h>
+
+#include "mirac_dds_log.h"
+#include "mirac_dds_link.h"
+
+LOG_MODULE_DECLARE(DDS, LOG_LEVEL_INF);
+
+// The zephyr transports keep their state in globals, there is only ever
+// one link and one receive thread
+K_THREAD_STACK_DEFINE(link_thread_stack, CONFIG_MICROXRCEDDSCLIENT_LINK_THREAD_STACK_SIZE);
+static struct k_thread link_thread_data;
+
+// XRCE message header: session id, stream id, sequence number, then the
+// client key for session ids below 0x80
+#define XRCE_HEADER_KEY_OFFSET 4
+#define XRCE_HEADER_WITH_KEY_SIZE 8
+#define XRCE_SESSION_ID_WITHOUT_KEY 0x80
+
+static void link_thread_entry(void *p1, void *p2, void *p3)
+{
+    MiracDDSLink *self = reinterpret_cast<MiracDDSLink *>(p1);
+    if (self)
+    {
+        self->receiveLoop();
+    }
+}
+
+MiracDDSLink::MiracDDSLink()
+    : transport_{}, params_{}, rx_framing_{}, tx_framing_{}, tx_lock_{}, open_lock_{}, ports_{}, rx_{}
+{
+    k_mutex_init(&tx_lock_);
+    k_mutex_init(&open_lock_);
+    transport_.args = &params_;
+    // Same local address as the uxr custom transport uses
+    uxr_init_framing_io(&rx_framing_, 0x00);
+    uxr_init_framing_io(&tx_framing_, 0x00);
+}
+
+int MiracDDSLink::attach(uint32_t client_key)
+{
+    if (num_ports_ == MAX_SESSIONS)
+    {
+        LOG_ERR("Link has no free port, raise CONFIG_MICROXRCEDDSCLIENT_LINK_MAX_SESSIONS");
+        return INVALID_PORT;
+    }
+
+    port &p = ports_[num_ports_];
+    // Most significant byte first, as uxr_init_session lays it out
+    p.key[0] = (uint8_t)(client_key >> 24);
+    p.key[1] = (uint8_t)(client_key >> 16);
+    p.key[2] = (uint8_t)(client_key >> 8);
+    p.key[3] = (uint8_t)client_key;
+    atomic_set(&p.connecting, 0);
+    k_msgq_init(&p.inbox, p.inbox_buffer, sizeof(message), INBOX_DEPTH);
+    return num_ports_++;
+}
+
+bool MiracDDSLink::open()
+{
+    k_mutex_lock(&open_lock_, K_FOREVER);
+    if (!opened_)
+    {
+        opened_ = zephyr_transport_open(&transport_);
+        if (opened_)
+        {
+            k_tid_t tid = k_thread_create(&link_thread_data,
+                                          link_thread_stack,
+                                          K_THREAD_STACK_SIZEOF(link_thread_stack),
+                                          link_thread_entry,
+                                          this, nullptr, nullptr,
+                                          CONFIG_MICROXRCEDDSCLIENT_LINK_THREAD_PRIORITY,
+                                          0,
+                                          K_NO_WAIT);
+            k_thread_name_set(tid, "mirac_dds_link");
+            LOG_INF("Shared link open, %u sessions.", (unsigned)num_ports_);
+        }
+    }
+    const bool ok = opened_;
+    k_mutex_unlock(&open_lock_);
+    return ok;
+}
+
+void MiracDDSLink::setConnecting(uint8_t port, bool connecting)
+{
+    atomic_set(&ports_[port].connecting, connecting ? 1 : 0);
+}
+
+size_t MiracDDSLink::write(const uint8_t *buf, size_t len, uint8_t *err)
+{
+    // Whole messages only, a frame must not interleave with another session's
+    k_mutex_lock(&tx_lock_, K_FOREVER);
+    const size_t wrote = ZEPHYR_TRANSPORT_FRAMING
+                             ? uxr_write_framed_msg(&tx_framing_, framing_write, this, buf, len, 0x00, err)
+                             : zephyr_transport_write(&transport_, buf, len, err);
+    k_mutex_unlock(&tx_lock_);
+    return wrote;
+}
+
+size_t MiracDDSLink::read(uint8_t port, uint8_t *buf, size_t len, int timeout, uint8_t *err)
+{
+    ARG_UNUSED(err);
+    struct MiracDDSLink::port &p = ports_[port];
+
+    if (k_msgq_get(&p.inbox, &p.received, (timeout < 0) ? K_FOREVER : K_MSEC(timeout)) != 0)
+    {
+        return 0;
+    }
+
+    const size_t read = MIN((size_t)p.received.len, len);
+    memcpy(buf, p.received.data, read);
+    return read;
+}
+
+void MiracDDSLink::receiveLoop()
+{
+    uint8_t err = 0;
+    while (true)
+    {
+        const size_t read = readTransport(rx_.data, sizeof(rx_.data), READ_SLICE_MS, &err);
+        if (read > 0)
+        {
+            rx_.len = (uint16_t)read;
+            route();
+        }
+    }
+}
+
+size_t MiracDDSLink::readTransport(uint8_t *buf, size_t len, int timeout, uint8_t *err)
+{
+    if (!ZEPHYR_TRANSPORT_FRAMING)
+    {
+        // Datagram transports hand over one message per read
+        return zephyr_transport_read(&transport_, buf, len, timeout, err);
+    }
+
+    // Same loop as the uxr custom transport, the framing consumes the
+    // timeout until a whole frame is in
+    uint8_t remote_addr = 0x00;
+    size_t read = 0;
+    do
+    {
+        read = uxr_read_framed_msg(&rx_framing_, framing_read, this, buf, len, &remote_addr, &timeout, err);
+    } while (read == 0 && timeout > 0);
+    return read;
+}
+
+void MiracDDSLink::route()
+{
+    const bool has_key = (rx_.len >= XRCE_HEADER_WITH_KEY_SIZE) && (rx_.data[0] < XRCE_SESSION_ID_WITHOUT_KEY);
+    bool claimed = false;
+
+    for (uint8_t i = 0; i < num_ports_; ++i)
+    {
+        port &p = ports_[i];
+        const bool addressed = has_key
+                                   ? (memcmp(p.key, &rx_.data[XRCE_HEADER_KEY_OFFSET], sizeof(p.key)) == 0)
+                                   : (atomic_get(&p.connecting) != 0);
+        if (!addressed)
+        {
+            continue;
+        }
+
+        claimed = true;
+        if (k_msgq_put(&p.inbox, &rx_, K_NO_WAIT) != 0)
+        {
+            // The session thread fell behind, uxr retransmits reliable data
+            atomic_inc(&dropped_);
+            DDS_HOT_LOG_WRN("Link inbox of session %u full, message dropped", (unsigned)i);
+        }
+        if (has_key)
+        {
+            break;
+        }
+    }
+
+    if (!claimed)
+    {
+        atomic_inc(&dropped_);
+    }
+}
+
+size_t MiracDDSLink::framing_write(void *args, const uint8_t *buf, size_t len, uint8_t *err)
+{
+    MiracDDSLink *self = static_cast<MiracDDSLink *>(args);
+    return zephyr_transport_write(&self->transport_, buf, len, err);
+}
+
+size_t MiracDDSLink::framing_read(void *args, uint8_t *buf, size_t len, int timeout, uint8_t *err)
+{
+    MiracDDSLink *self = static_cast<MiracDDSLink *>(args);
+    return zephyr_transport_read(&self->transport_, buf, len, timeout, err);
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2025, Cody Gu <gujiaqi@iscas.ac.cn>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MIRAC_DDS_LINK_H_
+#define MIRAC_DDS_LINK_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <uxr/client/client.h>
+#include <uxr/client/profile/transport/stream_framing/stream_framing_protocol.h>
+#include "microxrce_transports.h"
+
+// One physical transport shared by several MiracDDS sessions.
+//
+// The link owns the zephyr transport and its framing, a receive thread
+// reads whole XRCE messages and routes them by the client key in their
+// header to the inbox of the session that presents it. Sessions talk to
+// the link through an unframed uxr custom transport, so each keeps its
+// own key, streams and thread.
+class MiracDDSLink
+{
+public:
+    inline static constexpr uint8_t MAX_SESSIONS = CONFIG_MICROXRCEDDSCLIENT_LINK_MAX_SESSIONS;
+    inline static constexpr size_t INBOX_DEPTH = CONFIG_MICROXRCEDDSCLIENT_LINK_INBOX_DEPTH;
+    inline static constexpr int INVALID_PORT = -1;
+    // Receive thread wakes this often even on a silent link
+    inline static constexpr int READ_SLICE_MS = 1000;
+
+    MiracDDSLink();
+
+    // Reserve the port of the session presenting client_key, call before
+    // any session thread starts; INVALID_PORT when the link is full
+    int attach(uint32_t client_key);
+
+    // Open the transport and start the receive thread on the first call,
+    // later calls return the result of the first one
+    bool open();
+
+    // While set, messages without a client key, ping replies before the
+    // session exists, are handed to this port as well
+    void setConnecting(uint8_t port, bool connecting);
+
+    // One whole XRCE message per call, from any session thread
+    size_t write(const uint8_t *buf, size_t len, uint8_t *err);
+    size_t read(uint8_t port, uint8_t *buf, size_t len, int timeout, uint8_t *err);
+
+    // Messages dropped for a full inbox or no matching session
+    uint32_t dropped() const
+    {
+        return (uint32_t)atomic_get(&dropped_);
+    }
+
+    // Receive thread body
+    void receiveLoop();
+
+private:
+    struct message
+    {
+        uint16_t len;
+        uint8_t data[UXR_CONFIG_CUSTOM_TRANSPORT_MTU];
+    };
+
+    struct port
+    {
+        uint8_t key[4]; // Client key as laid out in the message header
+        atomic_t connecting;
+        struct k_msgq inbox;
+        char inbox_buffer[sizeof(message) * INBOX_DEPTH] __aligned(4);
+        message received; // Inbox slot copied out by the session thread
+    };
+
+    // Read one whole message from the transport, 0 on timeout
+    size_t readTransport(uint8_t *buf, size_t len, int timeout, uint8_t *err);
+
+    // Hand rx_ to every port it is addressed to
+    void route();
+
+    static size_t framing_write(void *args, const uint8_t *buf, size_t len, uint8_t *err);
+    static size_t framing_read(void *args, uint8_t *buf, size_t len, int timeout, uint8_t *err);
+
+    // Only carries the params for the zephyr_transport_* calls
+    uxrCustomTransport transport_;
+    zephyr_transport_params_t params_;
+
+    uxrFramingIO rx_framing_; // Receive thread only
+    uxrFramingIO tx_framing_; // Under tx_lock_
+    struct k_mutex tx_lock_;
+    struct k_mutex open_lock_;
+    bool opened_{false};
+
+    port ports_[MAX_SESSIONS];
+    uint8_t num_ports_{0};
+
+    message rx_;
+    atomic_t dropped_{ATOMIC_INIT(0)};
+};
+
+#endif // MIRAC_DDS_LINK_H_
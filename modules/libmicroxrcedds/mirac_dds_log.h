@@ -0,0 +1,90 @@
+// Copyright (c) 2025, Cody Gu <gujiaqi@iscas.ac.cn>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MIRAC_DDS_LOG_H_
+#define MIRAC_DDS_LOG_H_
+
+#include <cstdint>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_HOT_PATH_LOG)
+// Token bucket of one logging call site, lets a burst of messages through
+// then one every interval/burst ms. The DDS threads of several MiracDDS
+// instances share a call site, a spinlock keeps the bucket consistent.
+class ddsLogLimiter
+{
+public:
+    inline static constexpr uint32_t INTERVAL_MS = CONFIG_MICROXRCEDDSCLIENT_LOG_RATELIMIT_INTERVAL_MS;
+    inline static constexpr uint32_t BURST = CONFIG_MICROXRCEDDSCLIENT_LOG_RATELIMIT_BURST;
+    inline static constexpr uint32_t COST_MS = INTERVAL_MS / BURST;
+    static_assert(COST_MS > 0, "Log rate limit interval must be at least the burst size in ms");
+
+    // True if the message may be logged, suppressed is the number of
+    // messages dropped at this call site since the last one let through
+    bool allow(uint32_t &suppressed)
+    {
+        const k_spinlock_key_t key = k_spin_lock(&lock_);
+        const uint32_t now_ms = k_uptime_get_32();
+        const uint32_t elapsed_ms = started_ ? now_ms - last_ms_ : INTERVAL_MS;
+
+        started_ = true;
+        last_ms_ = now_ms;
+        credit_ms_ = (elapsed_ms >= INTERVAL_MS - credit_ms_) ? INTERVAL_MS : credit_ms_ + elapsed_ms;
+
+        const bool allowed = (credit_ms_ >= COST_MS);
+        if (allowed)
+        {
+            credit_ms_ -= COST_MS;
+            suppressed = suppressed_;
+            suppressed_ = 0;
+        }
+        else
+        {
+            ++suppressed_;
+        }
+        k_spin_unlock(&lock_, key);
+        return allowed;
+    }
+
+private:
+    struct k_spinlock lock_{};
+    uint32_t last_ms_{0};
+    uint32_t credit_ms_{0};
+    uint32_t suppressed_{0};
+    bool started_{false};
+};
+
+// Logging for code that runs per sample or per spin, rate limited per call site
+#define DDS_HOT_LOG(level, ...)                                                          \
+    do                                                                                   \
+    {                                                                                    \
+        static ddsLogLimiter dds_log_limiter_;                                           \
+        uint32_t dds_log_suppressed_ = 0;                                                \
+        if (dds_log_limiter_.allow(dds_log_suppressed_))                                 \
+        {                                                                                \
+            if (dds_log_suppressed_ > 0)                                                 \
+            {                                                                            \
+                LOG_##level("%u similar messages suppressed", (unsigned)dds_log_suppressed_); \
+            }                                                                            \
+            LOG_##level(__VA_ARGS__);                                                    \
+        }                                                                                \
+    } while (0)
+#else
+// Stripped, the arguments are still type checked but no code is emitted
+#define DDS_HOT_LOG(level, ...)       \
+    do                                \
+    {                                 \
+        if (0)                        \
+        {                             \
+            LOG_##level(__VA_ARGS__); \
+        }                             \
+    } while (0)
+#endif
+
+#define DDS_HOT_LOG_ERR(...) DDS_HOT_LOG(ERR, __VA_ARGS__)
+#define DDS_HOT_LOG_WRN(...) DDS_HOT_LOG(WRN, __VA_ARGS__)
+#define DDS_HOT_LOG_INF(...) DDS_HOT_LOG(INF, __VA_ARGS__)
+#define DDS_HOT_LOG_DBG(...) DDS_HOT_LOG(DBG, __VA_ARGS__)
+
+#endif // MIRAC_DDS_LOG_H_
@@ -0,0 +1,99 @@
+// Copyright (c) 2025, Cody Gu <gujiaqi@iscas.ac.cn>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MIRAC_DDS_MSG_TYPES_H_
+#define MIRAC_DDS_MSG_TYPES_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <ucdr/microcdr.h>
+#include "builtin_interfaces/msg/Time.h"
+#include "std_msgs/msg/Header.h"
+#include "std_msgs/msg/String.h"
+
+#define ROS_DDS_MSG_TYPE_NAME(pkg, type) pkg "::msg::dds_::" type "_"
+
+// Every message type from uxrce_generated_msgs the topic list may use,
+// add new generated types here
+#define MIRAC_DDS_MSG_TYPES(X)  \
+    X(builtin_interfaces, Time) \
+    X(std_msgs, Header)         \
+    X(std_msgs, String)
+
+// Type-erased (de)serialization hooks of one generated message type
+struct msgType
+{
+    const char *type_name; // DDS type name
+    size_t sample_size;    // sizeof the generated struct
+    uint32_t fixed_size;   // Serialized size, 0 when the type has variable-length members
+    bool (*serialize)(ucdrBuffer *writer, const void *sample);
+    bool (*deserialize)(ucdrBuffer *reader, void *sample);
+    uint32_t (*size_of)(const void *sample, uint32_t size);
+    // size_of_sized records the string lengths serialize_sized then writes
+    // without another strlen, lengths holds sized_lengths entries
+    uint32_t sized_lengths;
+    uint32_t (*size_of_sized)(const void *sample, uint32_t size, uint32_t *lengths);
+    bool (*serialize_sized)(ucdrBuffer *writer, const void *sample, const uint32_t *lengths);
+};
+
+// Specialized for every entry of MIRAC_DDS_MSG_TYPES
+template <typename MsgT>
+struct msgTraits;
+
+#define MIRAC_DDS_MSG_TRAITS(pkg, name)                                                    \
+    template <>                                                                            \
+    struct msgTraits<pkg##_msg_##name>                                                     \
+    {                                                                                      \
+        using msg_type = pkg##_msg_##name;                                                 \
+        static bool serialize(ucdrBuffer *writer, const void *sample)                      \
+        {                                                                                  \
+            return pkg##_msg_##name##_serialize_topic(writer, static_cast<const msg_type *>(sample)); \
+        }                                                                                  \
+        static bool deserialize(ucdrBuffer *reader, void *sample)                          \
+        {                                                                                  \
+            return pkg##_msg_##name##_deserialize_topic(reader, static_cast<msg_type *>(sample)); \
+        }                                                                                  \
+        static uint32_t size_of(const void *sample, uint32_t size)                         \
+        {                                                                                  \
+            return pkg##_msg_##name##_size_of_topic(static_cast<const msg_type *>(sample), size); \
+        }                                                                                  \
+        static uint32_t size_of_sized(const void *sample, uint32_t size, uint32_t *lengths) \
+        {                                                                                  \
+            return pkg##_msg_##name##_size_of_topic_sized(static_cast<const msg_type *>(sample), size, lengths); \
+        }                                                                                  \
+        static bool serialize_sized(ucdrBuffer *writer, const void *sample, const uint32_t *lengths) \
+        {                                                                                  \
+            return pkg##_msg_##name##_serialize_topic_sized(writer, static_cast<const msg_type *>(sample), lengths); \
+        }                                                                                  \
+        inline static constexpr msgType descriptor{                                        \
+            ROS_DDS_MSG_TYPE_NAME(#pkg, #name), sizeof(msg_type), pkg##_msg_##name##_FIXED_SIZE, \
+            serialize, deserialize, size_of,                                               \
+            pkg##_msg_##name##_SIZED_LENGTHS, size_of_sized, serialize_sized};             \
+    };
+
+MIRAC_DDS_MSG_TYPES(MIRAC_DDS_MSG_TRAITS)
+
+// Most string lengths any registered type records, at least 1 to size arrays
+constexpr uint32_t msgMaxSizedLengths()
+{
+#define MIRAC_DDS_MSG_SIZED_LENGTHS(pkg, name) pkg##_msg_##name##_SIZED_LENGTHS,
+    constexpr uint32_t counts[] = {MIRAC_DDS_MSG_TYPES(MIRAC_DDS_MSG_SIZED_LENGTHS)};
+#undef MIRAC_DDS_MSG_SIZED_LENGTHS
+    uint32_t max = 1;
+    for (const uint32_t count : counts)
+    {
+        max = (count > max) ? count : max;
+    }
+    return max;
+}
+inline constexpr uint32_t MSG_MAX_SIZED_LENGTHS = msgMaxSizedLengths();
+
+// Storage large enough for a sample of any registered message type
+union msgSample
+{
+#define MIRAC_DDS_MSG_SAMPLE(pkg, name) pkg##_msg_##name pkg##_##name;
+    MIRAC_DDS_MSG_TYPES(MIRAC_DDS_MSG_SAMPLE)
+#undef MIRAC_DDS_MSG_SAMPLE
+};
+
+#endif // MIRAC_DDS_MSG_TYPES_H_
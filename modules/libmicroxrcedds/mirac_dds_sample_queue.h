@@ -0,0 +1,284 @@
+// Copyright (c) 2025, Cody Gu <gujiaqi@iscas.ac.cn>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MIRAC_DDS_SAMPLE_QUEUE_H_
+#define MIRAC_DDS_SAMPLE_QUEUE_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+// What a full SubscribeQueue does with a new sample
+enum class QueueOverflow : uint8_t
+{
+    DROP_NEWEST = 0, // Keep the queued samples, drop the new one
+    DROP_OLDEST = 1, // Make room by dropping the oldest unread sample
+};
+
+// Lock-free single-producer / single-consumer ring of message samples
+// shared between the DDS thread and one application thread. Samples are
+// filled and read in place, a full queue drops the new sample unless a
+// SubscribeQueue is set to QueueOverflow::DROP_OLDEST.
+class SampleQueueBase
+{
+public:
+    // Producer: slot to fill in place, nullptr when the queue is full
+    void *claimRaw()
+    {
+        if (full())
+        {
+            atomic_inc(&dropped_);
+            return nullptr;
+        }
+        return slot((uint32_t)atomic_get(&head_));
+    }
+
+    // Producer: hand the claimed slot over to the DDS thread
+    void commit()
+    {
+        atomic_inc(&head_);
+    }
+
+    bool pushRaw(const void *sample)
+    {
+        void *dst = claimRaw();
+        if (!dst)
+        {
+            return false;
+        }
+        memcpy(dst, sample, slot_size_);
+        commit();
+        return true;
+    }
+
+    // Consumer: oldest queued sample, nullptr when empty
+    const void *front() const
+    {
+        const uint32_t tail = (uint32_t)atomic_get(&tail_);
+        return (tail == (uint32_t)atomic_get(&head_)) ? nullptr : slot(tail);
+    }
+
+    // Consumer: release the sample returned by front()
+    void pop()
+    {
+        atomic_inc(&tail_);
+    }
+
+    bool full() const
+    {
+        return (uint32_t)atomic_get(&head_) - (uint32_t)atomic_get(&tail_) >= depth_;
+    }
+
+    // Samples rejected because the consumer fell behind
+    uint32_t dropped() const
+    {
+        return (uint32_t)atomic_get(&dropped_);
+    }
+
+protected:
+    SampleQueueBase(void *slots, size_t slot_size, uint32_t depth)
+        : slots_{static_cast<uint8_t *>(slots)}, slot_size_{slot_size}, depth_{depth}
+    {
+    }
+
+private:
+    void *slot(uint32_t pos) const
+    {
+        return slots_ + (pos & (depth_ - 1)) * slot_size_;
+    }
+
+    uint8_t *const slots_;
+    const size_t slot_size_;
+    const uint32_t depth_;
+    atomic_t head_{ATOMIC_INIT(0)}; // Written by the producer only
+    atomic_t tail_{ATOMIC_INIT(0)}; // Written by the DDS thread only
+    atomic_t dropped_{ATOMIC_INIT(0)};
+};
+
+// Application thread -> DDS thread. The producer never touches the
+// uxrSession and never blocks.
+template <typename MsgT, uint32_t Depth>
+class PublishQueue : public SampleQueueBase
+{
+    static_assert(Depth > 0 && (Depth & (Depth - 1)) == 0, "PublishQueue depth must be a power of two");
+
+public:
+    using msg_type = MsgT;
+
+    PublishQueue() : SampleQueueBase(slots_, sizeof(MsgT), Depth) {}
+
+    PublishQueue(const PublishQueue &) = delete;
+    PublishQueue &operator=(const PublishQueue &) = delete;
+
+    // Producer: fill the returned sample in place then commit()
+    MsgT *claim()
+    {
+        return static_cast<MsgT *>(claimRaw());
+    }
+
+    // Producer: copy a sample in, false when the queue is full
+    bool push(const MsgT &sample)
+    {
+        return pushRaw(&sample);
+    }
+
+private:
+    MsgT slots_[Depth]{};
+};
+
+// DDS thread side of a SubscribeQueue, wakes the consumer on delivery
+class SubscribeQueueBase : public SampleQueueBase
+{
+public:
+    // Set before the DDS thread starts
+    void setOverflow(QueueOverflow overflow)
+    {
+        drop_oldest_ = (overflow == QueueOverflow::DROP_OLDEST);
+    }
+
+    // DDS thread: slot for the next sample, nullptr when the queue is
+    // full. A full DROP_OLDEST queue takes the sample through
+    // replaceOldest() instead, once it deserialized fine.
+    void *claimSlot()
+    {
+        if (drop_oldest_ && full())
+        {
+            return nullptr;
+        }
+        return claimRaw();
+    }
+
+    bool dropsOldest() const
+    {
+        return drop_oldest_;
+    }
+
+    // DDS thread: queue a copy of sample in place of the oldest unread
+    // one, the sample is dropped while the consumer reads that one in place
+    bool replaceOldest(const void *sample)
+    {
+        const k_spinlock_key_t key = k_spin_lock(&lock_);
+        if (full() && !held_)
+        {
+            pop();
+            atomic_inc(&evicted_);
+        }
+        k_spin_unlock(&lock_, key);
+
+        if (!pushRaw(sample))
+        {
+            return false;
+        }
+        k_sem_give(&ready_);
+        return true;
+    }
+
+    // DDS thread: publish the slot filled through claimSlot()
+    void deliver()
+    {
+        commit();
+        k_sem_give(&ready_);
+    }
+
+    // Unread samples dropped to make room for newer ones
+    uint32_t evicted() const
+    {
+        return (uint32_t)atomic_get(&evicted_);
+    }
+
+protected:
+    SubscribeQueueBase(void *slots, size_t slot_size, uint32_t depth)
+        : SampleQueueBase(slots, slot_size, depth)
+    {
+        k_sem_init(&ready_, 0, 1);
+    }
+
+    // Consumer: oldest sample, waiting up to timeout for one to arrive
+    const void *wait(k_timeout_t timeout)
+    {
+        const k_timepoint_t end = sys_timepoint_calc(timeout);
+        const void *sample;
+        while ((sample = hold()) == nullptr)
+        {
+            if (k_sem_take(&ready_, sys_timepoint_timeout(end)) != 0)
+            {
+                return nullptr;
+            }
+        }
+        return sample;
+    }
+
+    // Consumer: give the slot returned by wait() back
+    void unhold()
+    {
+        if (!drop_oldest_)
+        {
+            pop();
+            return;
+        }
+
+        const k_spinlock_key_t key = k_spin_lock(&lock_);
+        pop();
+        held_ = false;
+        k_spin_unlock(&lock_, key);
+    }
+
+private:
+    // Consumer: front(), pinned against eviction until unhold()
+    const void *hold()
+    {
+        if (!drop_oldest_)
+        {
+            return front();
+        }
+
+        const k_spinlock_key_t key = k_spin_lock(&lock_);
+        const void *sample = front();
+        held_ = (sample != nullptr);
+        k_spin_unlock(&lock_, key);
+        return sample;
+    }
+
+    struct k_sem ready_;
+    // Only taken with DROP_OLDEST, where both threads move the tail
+    struct k_spinlock lock_{};
+    bool held_{false};
+    bool drop_oldest_{false};
+    atomic_t evicted_{ATOMIC_INIT(0)};
+};
+
+// DDS thread -> application thread. on_topic deserializes straight into a
+// free slot and hands it over by index, the consumer reads it in place.
+template <typename MsgT, uint32_t Depth>
+class SubscribeQueue : public SubscribeQueueBase
+{
+    static_assert(Depth > 0 && (Depth & (Depth - 1)) == 0, "SubscribeQueue depth must be a power of two");
+
+public:
+    using msg_type = MsgT;
+
+    SubscribeQueue() : SubscribeQueueBase(slots_, sizeof(MsgT), Depth) {}
+
+    SubscribeQueue(const SubscribeQueue &) = delete;
+    SubscribeQueue &operator=(const SubscribeQueue &) = delete;
+
+    // Consumer: oldest received sample, nullptr on timeout. The sample
+    // stays valid until release().
+    const MsgT *receive(k_timeout_t timeout = K_FOREVER)
+    {
+        return static_cast<const MsgT *>(wait(timeout));
+    }
+
+    // Consumer: give the slot returned by receive() back to the DDS thread
+    void release()
+    {
+        unhold();
+    }
+
+private:
+    MsgT slots_[Depth]{};
+};
+
+#endif // MIRAC_DDS_SAMPLE_QUEUE_H_
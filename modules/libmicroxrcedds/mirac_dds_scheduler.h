@@ -0,0 +1,172 @@
+// Copyright (c) 2025, Cody Gu <gujiaqi@iscas.ac.cn>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MIRAC_DDS_SCHEDULER_H_
+#define MIRAC_DDS_SCHEDULER_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <zephyr/sys/__assert.h>
+
+// Fixed capacity min-heap of periodic deadlines.
+// Every entry is re-armed one period after its previous deadline, so
+// publishers don't drift with the loop latency.
+template <size_t N>
+class DeadlineScheduler
+{
+public:
+    inline static constexpr int64_t NO_DEADLINE = INT64_MAX;
+
+    void clear()
+    {
+        size_ = 0;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    // Add a periodic entry, first due at now_ms
+    bool add(uint8_t id, uint32_t period_ms, int64_t now_ms)
+    {
+        if (size_ >= N || period_ms == 0)
+        {
+            return false;
+        }
+
+        heap_[size_] = entry{now_ms, period_ms, id};
+        siftUp(size_++);
+        return true;
+    }
+
+    // Period of the entry with this id, 0 if it is not scheduled
+    uint32_t period(uint8_t id) const
+    {
+        const size_t i = find(id);
+        return (i < size_) ? heap_[i].period_ms : 0;
+    }
+
+    // Drop the entry with this id, the others keep their deadlines
+    bool remove(uint8_t id)
+    {
+        const size_t i = find(id);
+        if (i >= size_)
+        {
+            return false;
+        }
+
+        heap_[i] = heap_[--size_];
+        if (i < size_)
+        {
+            siftDown(i);
+            siftUp(i);
+        }
+        return true;
+    }
+
+    // Earliest deadline, NO_DEADLINE if nothing is scheduled
+    int64_t nextDeadline() const
+    {
+        return empty() ? NO_DEADLINE : heap_[0].deadline_ms;
+    }
+
+    // Pop the earliest entry if it is due and re-arm it for its next period.
+    // Entries due within window_ms are popped early as well, unless their
+    // period is shorter than the window. An entry is popped at most once
+    // per pass: when its next period would still be due, after a late
+    // wakeup, it is re-armed one period from now instead of being
+    // published back to back.
+    bool popDue(int64_t now_ms, uint8_t &id, uint32_t window_ms = 0)
+    {
+        if (empty() || !isDue(heap_[0], now_ms, window_ms))
+        {
+            return false;
+        }
+
+        entry &top = heap_[0];
+        id = top.id;
+        top.deadline_ms += top.period_ms;
+        if (isDue(top, now_ms, window_ms))
+        {
+            top.deadline_ms = now_ms + top.period_ms;
+        }
+        __ASSERT(!isDue(top, now_ms, window_ms), "Scheduler entry %u due twice in one pass", (unsigned)id);
+        siftDown(0);
+        return true;
+    }
+
+private:
+    struct entry
+    {
+        int64_t deadline_ms;
+        uint32_t period_ms;
+        uint8_t id;
+    };
+
+    static bool isDue(const entry &e, int64_t now_ms, uint32_t window_ms)
+    {
+        return (e.deadline_ms <= now_ms) || (e.period_ms > window_ms && e.deadline_ms <= now_ms + window_ms);
+    }
+
+    size_t find(uint8_t id) const
+    {
+        size_t i = 0;
+        while (i < size_ && heap_[i].id != id)
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    void swap(size_t a, size_t b)
+    {
+        const entry tmp = heap_[a];
+        heap_[a] = heap_[b];
+        heap_[b] = tmp;
+    }
+
+    void siftUp(size_t i)
+    {
+        while (i > 0)
+        {
+            const size_t parent = (i - 1) / 2;
+            if (heap_[parent].deadline_ms <= heap_[i].deadline_ms)
+            {
+                break;
+            }
+            swap(parent, i);
+            i = parent;
+        }
+    }
+
+    void siftDown(size_t i)
+    {
+        while (true)
+        {
+            const size_t left = 2 * i + 1;
+            const size_t right = left + 1;
+            size_t smallest = i;
+
+            if (left < size_ && heap_[left].deadline_ms < heap_[smallest].deadline_ms)
+            {
+                smallest = left;
+            }
+            if (right < size_ && heap_[right].deadline_ms < heap_[smallest].deadline_ms)
+            {
+                smallest = right;
+            }
+            if (smallest == i)
+            {
+                break;
+            }
+            swap(smallest, i);
+            i = smallest;
+        }
+    }
+
+    entry heap_[N]{};
+    size_t size_{0};
+};
+
+#endif // MIRAC_DDS_SCHEDULER_H_
@@ -0,0 +1,164 @@
+// Copyright (c) 2025, Cody Gu <gujiaqi@iscas.ac.cn>
+// SPDX-License-Identifier: Apache-2.0
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mirac_dds_client.h"
+#include "mirac_dds_topic_list.h"
+
+static constexpr size_t topics_count = sizeof(MiracDDS::topics) / sizeof(MiracDDS::topics[0]);
+
+// topics[] index from a name or a number, -1 after printing an error
+static int parse_topic(const struct shell *sh, const char *arg)
+{
+    char *end;
+    const unsigned long index = strtoul(arg, &end, 10);
+    if (*arg != '\0' && *end == '\0')
+    {
+        if (index < topics_count)
+        {
+            return (int)index;
+        }
+    }
+    else
+    {
+        const int found = MiracDDS::findTopic(arg);
+        if (found >= 0)
+        {
+            return found;
+        }
+    }
+
+    shell_error(sh, "Unknown topic '%s'", arg);
+    return -1;
+}
+
+static int cmd_topics(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    for (size_t i = 0; i < topics_count; ++i)
+    {
+        const MiracDDS::topicList &t = MiracDDS::topics[i];
+        if (t.role_type == MiracDDS::topicRole::TOPIC_ROLE_PUB)
+        {
+            shell_print(sh, "%3u pub %-3s %6u ms (built %u) %s", (unsigned)i, MiracDDS::topicEnabled(i) ? "on" : "off",
+                        (unsigned)MiracDDS::topicRate(i), (unsigned)t.rate_limit, t.topic_name);
+        }
+        else
+        {
+            shell_print(sh, "%3u sub %-3s %s", (unsigned)i, MiracDDS::topicEnabled(i) ? "on" : "off", t.topic_name);
+        }
+    }
+    return 0;
+}
+
+static int set_enabled(const struct shell *sh, size_t argc, char **argv, bool enabled)
+{
+    if (argc == 2 && strcmp(argv[1], "all") == 0)
+    {
+        for (size_t i = 0; i < topics_count; ++i)
+        {
+            (void)MiracDDS::setTopicEnabled(i, enabled);
+        }
+        return 0;
+    }
+
+    for (size_t arg = 1; arg < argc; ++arg)
+    {
+        const int index = parse_topic(sh, argv[arg]);
+        if (index < 0)
+        {
+            return -EINVAL;
+        }
+        (void)MiracDDS::setTopicEnabled(index, enabled);
+    }
+    return 0;
+}
+
+static int cmd_enable(const struct shell *sh, size_t argc, char **argv)
+{
+    return set_enabled(sh, argc, argv, true);
+}
+
+static int cmd_disable(const struct shell *sh, size_t argc, char **argv)
+{
+    return set_enabled(sh, argc, argv, false);
+}
+
+static int cmd_rate(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+
+    uint32_t rate_ms = MiracDDS::RATE_DEFAULT;
+    if (strcmp(argv[2], "default") != 0)
+    {
+        char *end;
+        const unsigned long value = strtoul(argv[2], &end, 10);
+        if (*argv[2] == '\0' || *end != '\0' || value >= MiracDDS::RATE_DEFAULT)
+        {
+            shell_error(sh, "Rate must be a period in ms or 'default'");
+            return -EINVAL;
+        }
+        rate_ms = (uint32_t)value;
+    }
+
+    if (strcmp(argv[1], "all") == 0)
+    {
+        for (size_t i = 0; i < topics_count; ++i)
+        {
+            (void)MiracDDS::setTopicRate(i, rate_ms);
+        }
+        return 0;
+    }
+
+    const int index = parse_topic(sh, argv[1]);
+    if (index < 0)
+    {
+        return -EINVAL;
+    }
+    if (!MiracDDS::setTopicRate(index, rate_ms))
+    {
+        if (MiracDDS::topics[index].role_type != MiracDDS::topicRole::TOPIC_ROLE_PUB)
+        {
+            shell_error(sh, "Only publishers have a rate");
+        }
+        else
+        {
+            shell_error(sh, "'%s' only publishes on a deadline, rate 0 is not allowed", argv[1]);
+        }
+        return -EINVAL;
+    }
+    return 0;
+}
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS_SETTINGS)
+static int cmd_save(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    const int err = MiracDDS::saveTopicConfig();
+    if (err)
+    {
+        shell_error(sh, "Failed to save topic settings: %d", err);
+    }
+    return err;
+}
+#endif
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_dds,
+    SHELL_CMD_ARG(topics, NULL, "List topics with their state and rate", cmd_topics, 1, 0),
+    SHELL_CMD_ARG(enable, NULL, "Enable topics: <name|index>... | all", cmd_enable, 2, 254),
+    SHELL_CMD_ARG(disable, NULL, "Disable topics: <name|index>... | all", cmd_disable, 2, 254),
+    SHELL_CMD_ARG(rate, NULL, "Set a publish period: <name|index|all> <ms|default>", cmd_rate, 3, 0),
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS_SETTINGS)
+    SHELL_CMD_ARG(save, NULL, "Keep the current topic state across reboots", cmd_save, 1, 0),
+#endif
+    SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(dds, &sub_dds, "MiracDDS client", NULL);
@@ -0,0 +1,168 @@
+// Copyright (c) 2025, Cody Gu <gujiaqi@iscas.ac.cn>
+// SPDX-License-Identifier: Apache-2.0
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <string.h>
+#include <zephyr/logging/log.h>
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS_SETTINGS)
+#include <zephyr/settings/settings.h>
+#endif
+
+#include "mirac_dds_client.h"
+#include "mirac_dds_topic_list.h"
+
+LOG_MODULE_REGISTER(DDS_TOPICS, LOG_LEVEL_INF);
+
+// All zero is the topics[] table as built: enabled, rate_limit as is
+static ATOMIC_DEFINE(topic_disabled, MiracDDS::DDS_MAX_TOPICS);
+// Publish period plus one, 0 for topics[].rate_limit
+static atomic_t topic_rate[MiracDDS::DDS_MAX_TOPICS];
+static atomic_t topic_config_version = ATOMIC_INIT(0);
+
+static constexpr size_t topics_count = sizeof(MiracDDS::topics) / sizeof(MiracDDS::topics[0]);
+
+// Publishers filled by MiracDDS itself on their deadline, with no queue
+// or stream a rate of 0 could publish from
+static bool selfPublished(size_t index)
+{
+#if defined(CONFIG_MICROXRCEDDSCLIENT_DIAGNOSTICS)
+    if (index == to_underlying(TopicIndex::DIAGNOSTICS_PUB))
+    {
+        return true;
+    }
+#endif
+#if CONFIG_MICROXRCEDDSCLIENT_LOAD_TOPICS > 0
+    if (index >= to_underlying(TopicIndex::LOAD_PUB_FIRST) && index <= to_underlying(TopicIndex::LOAD_PUB_LAST))
+    {
+        return true;
+    }
+#endif
+    ARG_UNUSED(index);
+    return false;
+}
+
+bool MiracDDS::setTopicEnabled(size_t index, bool enabled)
+{
+    if (index >= topics_count)
+    {
+        return false;
+    }
+
+    atomic_set_bit_to(topic_disabled, index, !enabled);
+    atomic_inc(&topic_config_version);
+    return true;
+}
+
+bool MiracDDS::setTopicRate(size_t index, uint32_t rate_ms)
+{
+    // Subscribers are not scheduled
+    if (index >= topics_count || topics[index].role_type != topicRole::TOPIC_ROLE_PUB)
+    {
+        return false;
+    }
+    if (rate_ms == 0 && selfPublished(index))
+    {
+        return false;
+    }
+
+    atomic_set(&topic_rate[index], (rate_ms == RATE_DEFAULT) ? 0 : (atomic_val_t)(rate_ms + 1));
+    atomic_inc(&topic_config_version);
+    return true;
+}
+
+bool MiracDDS::topicEnabled(size_t index)
+{
+    return !atomic_test_bit(topic_disabled, index);
+}
+
+uint32_t MiracDDS::topicRate(size_t index)
+{
+    const uint32_t rate = (uint32_t)atomic_get(&topic_rate[index]);
+    return rate ? rate - 1 : topics[index].rate_limit;
+}
+
+uint32_t MiracDDS::topicConfigVersion()
+{
+    return (uint32_t)atomic_get(&topic_config_version);
+}
+
+int MiracDDS::findTopic(const char *name)
+{
+    for (size_t i = 0; i < topics_count; ++i)
+    {
+        const char *topic_name = topics[i].topic_name;
+        const char *last = strrchr(topic_name, '/');
+        if (strcmp(topic_name, name) == 0 || (last && strcmp(last + 1, name) == 0))
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+#if defined(CONFIG_MICROXRCEDDSCLIENT_RUNTIME_TOPICS_SETTINGS)
+
+#define TOPIC_SETTINGS_SUBTREE "miracdds/topic"
+
+// Value stored under miracdds/topic/<topic_name>
+struct topicSetting
+{
+    uint32_t rate; // As in topic_rate
+    uint8_t enabled;
+};
+
+static int topic_settings_set(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+    // Entries of topics no longer in the table are ignored
+    const int index = MiracDDS::findTopic(key);
+    if (index < 0 || len != sizeof(topicSetting))
+    {
+        LOG_WRN("Ignoring topic setting '%s'", key);
+        return 0;
+    }
+
+    topicSetting setting;
+    const ssize_t got = read_cb(cb_arg, &setting, sizeof(setting));
+    if (got != (ssize_t)sizeof(setting))
+    {
+        return (got < 0) ? (int)got : -EINVAL;
+    }
+
+    if (setting.rate == 1 && selfPublished(index))
+    {
+        LOG_WRN("Topic '%s' can't publish on every pass, keeping its rate", key);
+        setting.rate = 0;
+    }
+
+    atomic_set_bit_to(topic_disabled, index, !setting.enabled);
+    atomic_set(&topic_rate[index], (atomic_val_t)setting.rate);
+    atomic_inc(&topic_config_version);
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(miracdds_topic, TOPIC_SETTINGS_SUBTREE, nullptr, topic_settings_set, nullptr, nullptr);
+
+int MiracDDS::saveTopicConfig()
+{
+    int err = 0;
+    for (size_t i = 0; i < topics_count; ++i)
+    {
+        char key[SETTINGS_MAX_NAME_LEN + 1];
+        snprintk(key, sizeof(key), TOPIC_SETTINGS_SUBTREE "/%s", topics[i].topic_name);
+
+        const topicSetting setting{(uint32_t)atomic_get(&topic_rate[i]), (uint8_t)topicEnabled(i)};
+        // Topics left as built take no storage
+        const int rc = (setting.enabled && setting.rate == 0)
+                           ? settings_delete(key)
+                           : settings_save_one(key, &setting, sizeof(setting));
+        if (rc != 0)
+        {
+            LOG_ERR("Failed to save topic setting '%s': %d", key, rc);
+            err = err ? err : rc;
+        }
+    }
+    return err;
+}
+
+#endif
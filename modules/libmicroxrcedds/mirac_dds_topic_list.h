@@ -7,6 +7,7 @@
 #include "mirac_dds_client.h"
 #include <cstdint>
 #include <uxr/client/client.h>
+#include <zephyr/sys/util.h>
 
 #define DDS_DELAY_TIME_SYNC_MS (60000)
 #define DDS_DELAY_TALKER_TOPIC_MS (1000)
@@ -19,6 +20,13 @@ enum class TopicIndex : uint8_t
 {
     TALKER_PUB = 0,
     CHATTER_SUB,
+#if CONFIG_MICROXRCEDDSCLIENT_LOAD_TOPICS > 0
+    LOAD_PUB_FIRST,
+    LOAD_PUB_LAST = LOAD_PUB_FIRST + CONFIG_MICROXRCEDDSCLIENT_LOAD_TOPICS - 1,
+#endif
+#if defined(CONFIG_MICROXRCEDDSCLIENT_DIAGNOSTICS)
+    DIAGNOSTICS_PUB, // Built-in, keep last
+#endif
 };
 
 static inline constexpr uint8_t to_underlying(const TopicIndex index)
@@ -27,14 +35,35 @@ static inline constexpr uint8_t to_underlying(const TopicIndex index)
     return static_cast<uint8_t>(index);
 }
 
-constexpr struct MiracDDS::topicList MiracDDS::topics[] = {
+#if CONFIG_MICROXRCEDDSCLIENT_LOAD_TOPICS > 0
+// Entry i of the synthetic load publishers, published by MiracDDS itself
+#define MIRAC_DDS_LOAD_TOPIC(i, _)                                                                     \
+    {                                                                                                  \
+        .topic_id = (uxrObjectId){.id = to_underlying(TopicIndex::LOAD_PUB_FIRST) + i, .type = UXR_TOPIC_ID}, \
+        .role_type = topicRole::TOPIC_ROLE_PUB,                                                        \
+        .role_id = (uxrObjectId){.id = to_underlying(TopicIndex::LOAD_PUB_FIRST) + i, .type = UXR_PUBLISHER_ID}, \
+        .data_entity_id = (uxrObjectId){.id = to_underlying(TopicIndex::LOAD_PUB_FIRST) + i, .type = UXR_DATAWRITER_ID}, \
+        .topic_name = ROS_DDS_TOPIC_NAMESPACE(TOPIC_NS, "load_" STRINGIFY(i)),                         \
+        .msg_type = &msgTraits<builtin_interfaces_msg_Time>::descriptor,                               \
+        .rate_limit = CONFIG_MICROXRCEDDSCLIENT_LOAD_TOPIC_PERIOD_MS,                                  \
+        .qos = (uxrQoS_t){                                                                             \
+            .durability = UXR_DURABILITY_VOLATILE,                                                     \
+            .reliability = UXR_RELIABILITY_RELIABLE,                                                   \
+            .history = UXR_HISTORY_KEEP_LAST,                                                          \
+            .depth = 1,                                                                                \
+        },                                                                                             \
+    }
+#endif
+
+inline constexpr struct MiracDDS::topicList MiracDDS::topics[] = {
     {
         .topic_id = (uxrObjectId){.id = to_underlying(TopicIndex::TALKER_PUB), .type = UXR_TOPIC_ID},
         .role_type = topicRole::TOPIC_ROLE_PUB,
         .role_id = (uxrObjectId){.id = to_underlying(TopicIndex::TALKER_PUB), .type = UXR_PUBLISHER_ID},
         .data_entity_id = (uxrObjectId){.id = to_underlying(TopicIndex::TALKER_PUB), .type = UXR_DATAWRITER_ID},
         .topic_name = ROS_DDS_TOPIC_NAMESPACE(TOPIC_NS, "HelloWorld"),
-        .type_name = ROS_DDS_MSG_TYPE_NAME("std_msgs", "String"),
+        .msg_type = &msgTraits<std_msgs_msg_String>::descriptor,
+        .rate_limit = DDS_DELAY_TALKER_TOPIC_MS,
         .qos = (uxrQoS_t){
             .durability = UXR_DURABILITY_VOLATILE,
             .reliability = UXR_RELIABILITY_RELIABLE,
@@ -48,14 +77,80 @@ constexpr struct MiracDDS::topicList MiracDDS::topics[] = {
         .role_id = (uxrObjectId){.id = to_underlying(TopicIndex::CHATTER_SUB), .type = UXR_SUBSCRIBER_ID},
         .data_entity_id = (uxrObjectId){.id=to_underlying(TopicIndex::CHATTER_SUB), .type=UXR_DATAREADER_ID},
         .topic_name = ROS_DDS_TOPIC_NAMESPACE(TOPIC_NS, "chatter"),
-        .type_name = ROS_DDS_MSG_TYPE_NAME("std_msgs", "String"),
+        .msg_type = &msgTraits<std_msgs_msg_String>::descriptor,
         .qos = (uxrQoS_t){
             .durability = UXR_DURABILITY_VOLATILE,
             .reliability = UXR_RELIABILITY_RELIABLE,
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        // At most 100 samples a second, the newest win when the reader lags
+        .delivery = {.min_pace_ms = 10},
+        .overflow = QueueOverflow::DROP_OLDEST,
     },
+#if CONFIG_MICROXRCEDDSCLIENT_LOAD_TOPICS > 0
+    LISTIFY(CONFIG_MICROXRCEDDSCLIENT_LOAD_TOPICS, MIRAC_DDS_LOAD_TOPIC, (,)),
+#endif
+#if defined(CONFIG_MICROXRCEDDSCLIENT_DIAGNOSTICS)
+    {
+        .topic_id = (uxrObjectId){.id = to_underlying(TopicIndex::DIAGNOSTICS_PUB), .type = UXR_TOPIC_ID},
+        .role_type = topicRole::TOPIC_ROLE_PUB,
+        .role_id = (uxrObjectId){.id = to_underlying(TopicIndex::DIAGNOSTICS_PUB), .type = UXR_PUBLISHER_ID},
+        .data_entity_id = (uxrObjectId){.id = to_underlying(TopicIndex::DIAGNOSTICS_PUB), .type = UXR_DATAWRITER_ID},
+        .topic_name = ROS_DDS_TOPIC_NAMESPACE(TOPIC_NS, "diagnostics"),
+        .msg_type = &msgTraits<std_msgs_msg_String>::descriptor,
+        .rate_limit = CONFIG_MICROXRCEDDSCLIENT_DIAGNOSTICS_PERIOD_MS,
+        .qos = (uxrQoS_t){
+            .durability = UXR_DURABILITY_VOLATILE,
+            .reliability = UXR_RELIABILITY_BEST_EFFORT,
+            .history = UXR_HISTORY_KEEP_LAST,
+            .depth = 1,
+        },
+    },
+#endif
 };
 
+static_assert(sizeof(MiracDDS::topics) / sizeof(MiracDDS::topics[0]) <= MiracDDS::DDS_MAX_TOPICS,
+              "Increase CONFIG_MICROXRCEDDSCLIENT_MAX_TOPICS");
+
+// on_topic dispatches by indexing topics[] with the received entity id
+static inline constexpr bool topic_ids_match_index()
+{
+    for (size_t i = 0; i < sizeof(MiracDDS::topics) / sizeof(MiracDDS::topics[0]); ++i)
+    {
+        const auto &t = MiracDDS::topics[i];
+        if (t.topic_id.id != i || t.role_id.id != i || t.data_entity_id.id != i)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(topic_ids_match_index(), "topics[] entity ids must equal their TopicIndex");
+
+// Fixed-size best-effort samples must fit a single MTU, reliable ones of
+// any size are fragmented
+static inline constexpr bool topic_sizes_fit_streams()
+{
+    constexpr size_t payload = MiracDDS::DDS_MTU - MiracDDS::DDS_WRITE_OVERHEAD;
+    for (const auto &t : MiracDDS::topics)
+    {
+        if (t.role_type == MiracDDS::topicRole::TOPIC_ROLE_PUB && t.qos.reliability == UXR_RELIABILITY_BEST_EFFORT &&
+            t.msg_type->fixed_size > payload)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(topic_sizes_fit_streams(),
+              "A fixed-size best-effort topic exceeds the MTU, raise the MTU or make it reliable");
+
+// Typed handles for writeTopic<T>() and subscribe<T>()
+using TalkerPub = MiracDDS::Topic<std_msgs_msg_String, MiracDDS::topicRole::TOPIC_ROLE_PUB, TopicIndex::TALKER_PUB>;
+using ChatterSub = MiracDDS::Topic<std_msgs_msg_String, MiracDDS::topicRole::TOPIC_ROLE_SUB, TopicIndex::CHATTER_SUB>;
+#if defined(CONFIG_MICROXRCEDDSCLIENT_DIAGNOSTICS)
+using DiagnosticsPub = MiracDDS::Topic<std_msgs_msg_String, MiracDDS::topicRole::TOPIC_ROLE_PUB, TopicIndex::DIAGNOSTICS_PUB>;
+#endif
+
 #endif // UXRCE_DDS_TOPIC_LIST_H_
\ No newline at end of file
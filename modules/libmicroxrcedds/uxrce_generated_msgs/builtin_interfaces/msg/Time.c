@@ -24,10 +24,21 @@
 #include <ucdr/microcdr.h>
 #include <string.h>
 
+_Static_assert(sizeof(builtin_interfaces_msg_Time) == 8u, "builtin_interfaces_msg_Time size changed");
+_Static_assert(_Alignof(builtin_interfaces_msg_Time) == 4u, "builtin_interfaces_msg_Time alignment changed");
+_Static_assert(builtin_interfaces_msg_Time_WIRE_LAYOUT, "builtin_interfaces_msg_Time struct layout differs from its CDR layout on this ABI");
+
 bool builtin_interfaces_msg_Time_serialize_topic(ucdrBuffer* writer, const builtin_interfaces_msg_Time* topic)
 {
     bool success = true;
 
+    // One copy when the stream is aligned for the whole sample
+    if (builtin_interfaces_msg_Time_WIRE_LAYOUT && writer->endianness == UCDR_MACHINE_ENDIANNESS &&
+        ucdr_buffer_alignment(writer, builtin_interfaces_msg_Time_WIRE_ALIGNMENT) == 0)
+    {
+        return ucdr_serialize_array_uint8_t(writer, (const uint8_t*)topic, builtin_interfaces_msg_Time_FIXED_SIZE) && !writer->error;
+    }
+
         success &= ucdr_serialize_int32_t(writer, topic->sec);
 
         success &= ucdr_serialize_uint32_t(writer, topic->nanosec);
@@ -39,6 +50,13 @@ bool builtin_interfaces_msg_Time_deserialize_topic(ucdrBuffer* reader, builtin_i
 {
     bool success = true;
 
+    // One copy when the stream is aligned for the whole sample
+    if (builtin_interfaces_msg_Time_WIRE_LAYOUT && reader->endianness == UCDR_MACHINE_ENDIANNESS &&
+        ucdr_buffer_alignment(reader, builtin_interfaces_msg_Time_WIRE_ALIGNMENT) == 0)
+    {
+        return ucdr_deserialize_array_uint8_t(reader, (uint8_t*)topic, builtin_interfaces_msg_Time_FIXED_SIZE) && !reader->error;
+    }
+
         success &= ucdr_deserialize_int32_t(reader, &topic->sec);
 
         success &= ucdr_deserialize_uint32_t(reader, &topic->nanosec);
@@ -55,3 +73,15 @@ uint32_t builtin_interfaces_msg_Time_size_of_topic(const builtin_interfaces_msg_
 
     return size - previousSize;
 }
+
+uint32_t builtin_interfaces_msg_Time_size_of_topic_sized(const builtin_interfaces_msg_Time* topic, uint32_t size, uint32_t* lengths)
+{
+    (void)lengths;
+    return builtin_interfaces_msg_Time_size_of_topic(topic, size);
+}
+
+bool builtin_interfaces_msg_Time_serialize_topic_sized(ucdrBuffer* writer, const builtin_interfaces_msg_Time* topic, const uint32_t* lengths)
+{
+    (void)lengths;
+    return builtin_interfaces_msg_Time_serialize_topic(writer, topic);
+}
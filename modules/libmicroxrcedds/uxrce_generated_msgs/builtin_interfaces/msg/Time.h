@@ -29,6 +29,7 @@ extern "C"
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 typedef struct builtin_interfaces_msg_Time
 {
@@ -42,6 +43,22 @@ bool builtin_interfaces_msg_Time_serialize_topic(struct ucdrBuffer* writer, cons
 bool builtin_interfaces_msg_Time_deserialize_topic(struct ucdrBuffer* reader, builtin_interfaces_msg_Time* topic);
 uint32_t builtin_interfaces_msg_Time_size_of_topic(const builtin_interfaces_msg_Time* topic, uint32_t size);
 
+// CDR serialized size when the type has no variable-length member, 0 otherwise
+#define builtin_interfaces_msg_Time_FIXED_SIZE 8u
+
+// String lengths size_of_topic_sized records for serialize_topic_sized, which then
+// writes the sample without another strlen
+#define builtin_interfaces_msg_Time_SIZED_LENGTHS (0u)
+uint32_t builtin_interfaces_msg_Time_size_of_topic_sized(const builtin_interfaces_msg_Time* topic, uint32_t size, uint32_t* lengths);
+bool builtin_interfaces_msg_Time_serialize_topic_sized(struct ucdrBuffer* writer, const builtin_interfaces_msg_Time* topic, const uint32_t* lengths);
+
+// Struct memory equals the little endian CDR encoding on this ABI
+#define builtin_interfaces_msg_Time_WIRE_LAYOUT (offsetof(builtin_interfaces_msg_Time, sec) == 0 && \
+    offsetof(builtin_interfaces_msg_Time, nanosec) == 4)
+// CDR alignment the whole sample needs for a single copy
+#define builtin_interfaces_msg_Time_WIRE_ALIGNMENT 4u
+
+
 
 #ifdef __cplusplus
 }
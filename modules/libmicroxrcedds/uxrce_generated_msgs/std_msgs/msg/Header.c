@@ -52,3 +52,22 @@ uint32_t std_msgs_msg_Header_size_of_topic(const std_msgs_msg_Header* topic, uin
 
     return size - previousSize;
 }
+
+uint32_t std_msgs_msg_Header_size_of_topic_sized(const std_msgs_msg_Header* topic, uint32_t size, uint32_t* lengths)
+{
+    uint32_t previousSize = size;
+        size += builtin_interfaces_msg_Time_size_of_topic_sized(&topic->stamp, size, lengths + 0);
+        size += ucdr_alignment(size, 4) + 4 + (lengths[builtin_interfaces_msg_Time_SIZED_LENGTHS] = (uint32_t)strlen(topic->frame_id)) + 1;
+
+    return size - previousSize;
+}
+
+bool std_msgs_msg_Header_serialize_topic_sized(ucdrBuffer* writer, const std_msgs_msg_Header* topic, const uint32_t* lengths)
+{
+    bool success = true;
+
+        success &= builtin_interfaces_msg_Time_serialize_topic_sized(writer, &topic->stamp, lengths + 0);
+        success &= ucdr_serialize_sequence_char(writer, topic->frame_id, lengths[builtin_interfaces_msg_Time_SIZED_LENGTHS] + 1);
+
+    return success && !writer->error;
+}
@@ -46,3 +46,18 @@ uint32_t std_msgs_msg_String_size_of_topic(const std_msgs_msg_String* topic, uin
         size += ucdr_alignment(size, 4) + 4 + (uint32_t)strlen(topic->data) + 1;
     return size - previousSize;
 }
+
+uint32_t std_msgs_msg_String_size_of_topic_sized(const std_msgs_msg_String* topic, uint32_t size, uint32_t* lengths)
+{
+    uint32_t previousSize = size;
+        size += ucdr_alignment(size, 4) + 4 + (lengths[0] = (uint32_t)strlen(topic->data)) + 1;
+    return size - previousSize;
+}
+
+bool std_msgs_msg_String_serialize_topic_sized(ucdrBuffer* writer, const std_msgs_msg_String* topic, const uint32_t* lengths)
+{
+    bool success = true;
+
+        success &= ucdr_serialize_sequence_char(writer, topic->data, lengths[0] + 1);
+    return success && !writer->error;
+}
@@ -42,6 +42,15 @@ bool std_msgs_msg_String_serialize_topic(struct ucdrBuffer* writer, const std_ms
 bool std_msgs_msg_String_deserialize_topic(struct ucdrBuffer* reader, std_msgs_msg_String* topic);
 uint32_t std_msgs_msg_String_size_of_topic(const std_msgs_msg_String* topic, uint32_t size);
 
+// CDR serialized size when the type has no variable-length member, 0 otherwise
+#define std_msgs_msg_String_FIXED_SIZE 0u
+
+// String lengths size_of_topic_sized records for serialize_topic_sized, which then
+// writes the sample without another strlen
+#define std_msgs_msg_String_SIZED_LENGTHS (1u)
+uint32_t std_msgs_msg_String_size_of_topic_sized(const std_msgs_msg_String* topic, uint32_t size, uint32_t* lengths);
+bool std_msgs_msg_String_serialize_topic_sized(struct ucdrBuffer* writer, const std_msgs_msg_String* topic, const uint32_t* lengths);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,124 @@
+// Copyright (c) 2025, Cody Gu <gujiaqi@iscas.ac.cn>
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef BENCH_STATS_H_
+#define BENCH_STATS_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+
+// Min/avg/max and a log2 histogram of measured values, bucket 0 holds 0,
+// bucket i holds [2^(i-1), 2^i) and the last one everything from
+// 2^(BUCKETS-2) up
+class BenchStats
+{
+public:
+    inline static constexpr size_t BUCKETS = 24;
+
+    void add(uint32_t value)
+    {
+        const size_t bucket = value ? MIN((size_t)(32 - __builtin_clz(value)), BUCKETS - 1) : 0;
+        ++buckets_[bucket];
+        ++count_;
+        sum_ += value;
+        min_ = MIN(min_, value);
+        max_ = MAX(max_, value);
+    }
+
+    uint32_t count() const
+    {
+        return count_;
+    }
+
+    uint32_t min() const
+    {
+        return count_ ? min_ : 0;
+    }
+
+    uint32_t avg() const
+    {
+        return count_ ? (uint32_t)(sum_ / count_) : 0;
+    }
+
+    uint32_t max() const
+    {
+        return max_;
+    }
+
+    // Largest value the given percentile can be: the end of its bucket,
+    // or the maximum seen once it lands in the open-ended last bucket
+    uint32_t percentile(uint32_t percent) const
+    {
+        const uint64_t target = ((uint64_t)count_ * percent + 99) / 100;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i)
+        {
+            seen += buckets_[i];
+            if (seen >= target && seen > 0)
+            {
+                return (i == BUCKETS - 1) ? max_ : MIN(bucketEnd(i) - 1, max_);
+            }
+        }
+        return max_;
+    }
+
+    void printSummary(const char *name, const char *unit) const
+    {
+        printk("%s: n=%u min=%u avg=%u p50<=%u p99<=%u max=%u %s\n", name, (unsigned)count_,
+               (unsigned)min(), (unsigned)avg(), (unsigned)percentile(50), (unsigned)percentile(99),
+               (unsigned)max_, unit);
+    }
+
+    void printHistogram(const char *unit) const
+    {
+        uint32_t peak = 0;
+        for (size_t i = 0; i < BUCKETS; ++i)
+        {
+            peak = MAX(peak, buckets_[i]);
+        }
+
+        for (size_t i = 0; i < BUCKETS; ++i)
+        {
+            if (buckets_[i] == 0)
+            {
+                continue;
+            }
+
+            char bar[41];
+            const size_t len = MAX((size_t)((uint64_t)buckets_[i] * (sizeof(bar) - 1) / peak), (size_t)1);
+            memset(bar, '#', len);
+            bar[len] = '\0';
+            if (i == BUCKETS - 1)
+            {
+                printk("  [%8u,      inf) %s %6u %s\n", (unsigned)bucketStart(i), unit, (unsigned)buckets_[i], bar);
+            }
+            else
+            {
+                printk("  [%8u, %8u) %s %6u %s\n", (unsigned)bucketStart(i), (unsigned)bucketEnd(i), unit,
+                       (unsigned)buckets_[i], bar);
+            }
+        }
+    }
+
+private:
+    static uint32_t bucketStart(size_t i)
+    {
+        return i ? (1U << (i - 1)) : 0;
+    }
+
+    static uint32_t bucketEnd(size_t i)
+    {
+        return 1U << i;
+    }
+
+    uint32_t buckets_[BUCKETS]{};
+    uint32_t count_{0};
+    uint64_t sum_{0};
+    uint32_t min_{UINT32_MAX};
+    uint32_t max_{0};
+};
+
+#endif // BENCH_STATS_H_
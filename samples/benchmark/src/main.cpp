@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2025, Cody Gu <gujiaqi@iscas.ac.cn>
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
+
+#include "mirac_dds_client.h"
+#include "mirac_dds_topic_list.h"
+#include "microxrce_transports.h"
+#include "bench_stats.h"
+
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+// Target and source of every (de)serialization run
+static uint8_t codec_buffer[1024];
+static msgSample codec_in;
+static msgSample codec_out;
+
+static uint32_t cyclesToNs(uint32_t cycles)
+{
+    return (uint32_t)k_cyc_to_ns_floor64(cycles);
+}
+
+// Worst case samples, variable-length members filled to capacity
+static void fillSample(builtin_interfaces_msg_Time &msg)
+{
+    msg.sec = 1700000000;
+    msg.nanosec = 999999999;
+}
+
+static void fillSample(std_msgs_msg_Header &msg)
+{
+    fillSample(msg.stamp);
+    memset(msg.frame_id, 'f', sizeof(msg.frame_id) - 1);
+    msg.frame_id[sizeof(msg.frame_id) - 1] = '\0';
+}
+
+static void fillSample(std_msgs_msg_String &msg)
+{
+    memset(msg.data, 's', sizeof(msg.data) - 1);
+    msg.data[sizeof(msg.data) - 1] = '\0';
+}
+
+template <typename MsgT>
+static void benchSerialize(const char *name)
+{
+    const msgType &type = msgTraits<MsgT>::descriptor;
+    MsgT &sample = *reinterpret_cast<MsgT *>(&codec_in);
+    fillSample(sample);
+
+    const uint32_t size = type.size_of(&sample, 0);
+    if (size > sizeof(codec_buffer))
+    {
+        printk("%s: %u bytes do not fit the codec buffer, skipped\n", name, (unsigned)size);
+        return;
+    }
+
+    BenchStats ser;
+    BenchStats de;
+    BenchStats pub;
+    BenchStats sized;
+    bool ok = true;
+    uint32_t lengths[MSG_MAX_SIZED_LENGTHS];
+    for (uint32_t i = 0; i < CONFIG_BENCH_SERIALIZE_ITERATIONS; ++i)
+    {
+        ucdrBuffer ub;
+        ucdr_init_buffer(&ub, codec_buffer, sizeof(codec_buffer));
+        uint32_t start = k_cycle_get_32();
+        ok &= type.serialize(&ub, &sample);
+        ser.add(k_cycle_get_32() - start);
+
+        // What publishing costs: size_of then serialize, once with both
+        // walking the strings and once as writeTopic does it
+        ucdr_init_buffer(&ub, codec_buffer, sizeof(codec_buffer));
+        start = k_cycle_get_32();
+        ok &= type.size_of(&sample, 0) == size && type.serialize(&ub, &sample);
+        pub.add(k_cycle_get_32() - start);
+
+        ucdr_init_buffer(&ub, codec_buffer, sizeof(codec_buffer));
+        start = k_cycle_get_32();
+        ok &= type.size_of_sized(&sample, 0, lengths) == size && type.serialize_sized(&ub, &sample, lengths);
+        sized.add(k_cycle_get_32() - start);
+
+        ucdr_init_buffer(&ub, codec_buffer, sizeof(codec_buffer));
+        start = k_cycle_get_32();
+        ok &= type.deserialize(&ub, &codec_out);
+        de.add(k_cycle_get_32() - start);
+    }
+
+    printk("%-28s %4u B  ser %6u/%6u/%6u cyc (%u ns)  de %6u/%6u/%6u cyc (%u ns)%s\n", name, (unsigned)size,
+           (unsigned)ser.min(), (unsigned)ser.avg(), (unsigned)ser.max(), (unsigned)cyclesToNs(ser.avg()),
+           (unsigned)de.min(), (unsigned)de.avg(), (unsigned)de.max(), (unsigned)cyclesToNs(de.avg()),
+           ok ? "" : "  CODEC ERROR");
+    printk("%-28s         size+ser %6u cyc (%u ns)  sized %6u cyc (%u ns)\n", "", (unsigned)pub.avg(),
+           (unsigned)cyclesToNs(pub.avg()), (unsigned)sized.avg(), (unsigned)cyclesToNs(sized.avg()));
+}
+
+static void benchSerialization()
+{
+    printk("Serialization, %u iterations, min/avg/max:\n", (unsigned)CONFIG_BENCH_SERIALIZE_ITERATIONS);
+#define BENCH_SERIALIZE(pkg, name) benchSerialize<pkg##_msg_##name>(#pkg "/" #name);
+    MIRAC_DDS_MSG_TYPES(BENCH_SERIALIZE)
+#undef BENCH_SERIALIZE
+}
+
+#if defined(CONFIG_BENCH_TRANSPORT)
+
+static void printTransportStats(const char *phase, uint64_t bytes, uint32_t elapsed_cycles)
+{
+    zephyr_transport_stats_t stats{};
+    zephyr_transport_get_stats(&stats);
+    const uint32_t ms = (uint32_t)k_cyc_to_ms_floor64(elapsed_cycles);
+    printk("%s: %u bytes in %u ms, %u B/s, isr=%u max=%u cyc total=%u cyc, tx_full=%u rx_dropped=%u\n", phase,
+           (unsigned)bytes, (unsigned)ms, ms ? (unsigned)(bytes * 1000 / ms) : 0U, (unsigned)stats.isr_count,
+           (unsigned)stats.isr_cycles_max, (unsigned)stats.isr_cycles_total, (unsigned)stats.tx_full,
+           (unsigned)stats.rx_dropped);
+}
+
+// Raw link throughput without XRCE on top, the host drains what is
+// written, then feeds data for the read phase
+static void benchTransport()
+{
+    static uxrCustomTransport transport;
+    static zephyr_transport_params_t params;
+    transport.args = &params;
+
+    if (!zephyr_transport_open(&transport))
+    {
+        printk("Failed to open the transport\n");
+        return;
+    }
+
+    static uint8_t pattern[256];
+    for (size_t i = 0; i < sizeof(pattern); ++i)
+    {
+        pattern[i] = (uint8_t)i;
+    }
+
+    printk("Transport write for %u ms\n", (unsigned)CONFIG_BENCH_TRANSPORT_MS);
+    BenchStats write_cycles;
+    uint64_t bytes = 0;
+    uint32_t start = k_cycle_get_32();
+    int64_t end_ms = k_uptime_get() + CONFIG_BENCH_TRANSPORT_MS;
+    while (k_uptime_get() < end_ms)
+    {
+        uint8_t err = 0;
+        const uint32_t call = k_cycle_get_32();
+        const size_t wrote = zephyr_transport_write(&transport, pattern, sizeof(pattern), &err);
+        write_cycles.add(k_cycle_get_32() - call);
+        bytes += wrote;
+        if (wrote < sizeof(pattern))
+        {
+            // Link saturated, let it drain
+            k_yield();
+        }
+    }
+    printTransportStats("write", bytes, k_cycle_get_32() - start);
+    write_cycles.printSummary("write call", "cyc");
+
+    printk("Transport read for %u ms\n", (unsigned)CONFIG_BENCH_TRANSPORT_MS);
+    static uint8_t rx[256];
+    bytes = 0;
+    start = k_cycle_get_32();
+    end_ms = k_uptime_get() + CONFIG_BENCH_TRANSPORT_MS;
+    while (k_uptime_get() < end_ms)
+    {
+        uint8_t err = 0;
+        bytes += zephyr_transport_read(&transport, rx, sizeof(rx), 10, &err);
+    }
+    printTransportStats("read", bytes, k_cycle_get_32() - start);
+}
+
+#else
+
+// Filled by the main thread, drained by the DDS thread at the talker deadline
+static PublishQueue<std_msgs_msg_String, 2> talker_queue;
+// The host relays the talker topic back on chatter
+static SubscribeQueue<std_msgs_msg_String, 4> echo_queue;
+
+// Publish on the talker topic and time until the echo arrives on chatter
+static void benchRoundtrip()
+{
+    // Stream buffers are too large for the main stack
+    static MiracDDS dds;
+    constexpr uint8_t talker = to_underlying(TopicIndex::TALKER_PUB);
+
+    dds.subscribe<ChatterSub>(echo_queue);
+    dds.advertise<TalkerPub>(talker_queue);
+    if (!dds.startThread())
+    {
+        printk("Failed to start MiracDDS thread\n");
+        return;
+    }
+
+    // Below the DDS thread, polling for the write never holds it off
+    k_thread_priority_set(k_current_get(), CONFIG_MICROXRCEDDSCLIENT_THREAD_PRIORITY + 1);
+
+    printk("Waiting for the agent\n");
+    while (!dds.isConnected())
+    {
+        k_sleep(K_MSEC(100));
+    }
+
+    printk("Round-trip, %u samples, echo through the host relay\n", (unsigned)CONFIG_BENCH_ROUNDTRIP_SAMPLES);
+    BenchStats rtt;
+    uint32_t lost = 0;
+    for (uint32_t seq = 0; seq < CONFIG_BENCH_ROUNDTRIP_SAMPLES; ++seq)
+    {
+        std_msgs_msg_String *msg = talker_queue.claim();
+        if (!msg)
+        {
+            k_sleep(K_MSEC(DDS_DELAY_TALKER_TOPIC_MS));
+            continue;
+        }
+        snprintf(msg->data, sizeof(msg->data), "bench %u", (unsigned)seq);
+
+        const uint32_t published = dds.stats(talker).samples;
+        talker_queue.commit();
+
+        // The talker period decides when the sample goes out, start the
+        // clock once the DDS thread wrote it
+        const int64_t deadline_ms = k_uptime_get() + DDS_DELAY_TALKER_TOPIC_MS + CONFIG_BENCH_ROUNDTRIP_TIMEOUT_MS;
+        while (dds.stats(talker).samples == published && k_uptime_get() < deadline_ms)
+        {
+            k_busy_wait(10);
+        }
+        const uint32_t start = k_cycle_get_32();
+
+        bool echoed = false;
+        while (!echoed)
+        {
+            const std_msgs_msg_String *echo = echo_queue.receive(K_MSEC(CONFIG_BENCH_ROUNDTRIP_TIMEOUT_MS));
+            if (!echo)
+            {
+                break;
+            }
+            // Late echoes of earlier samples are skipped
+            echoed = (strncmp(echo->data, "bench ", strlen("bench ")) == 0) &&
+                     (strtoul(echo->data + strlen("bench "), nullptr, 10) == seq);
+            echo_queue.release();
+        }
+
+        if (echoed)
+        {
+            rtt.add((uint32_t)k_cyc_to_us_floor64(k_cycle_get_32() - start));
+        }
+        else
+        {
+            ++lost;
+        }
+    }
+
+    rtt.printSummary("round-trip", "us");
+    rtt.printHistogram("us");
+    printk("lost=%u\n", (unsigned)lost);
+}
+
+#endif
+
+int main(void)
+{
+    printk("MiracDDS benchmark, cycle counter at %u Hz\n", (unsigned)sys_clock_hw_cycles_per_sec());
+
+    benchSerialization();
+
+#if defined(CONFIG_BENCH_TRANSPORT)
+    benchTransport();
+#else
+    benchRoundtrip();
+#endif
+
+    printk("Benchmark done\n");
+    return 0;
+}
@@ -11,13 +11,31 @@
 #include <time.h>
 
 #include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
 
 #include "mirac_dds_client.h"
+#include "mirac_dds_topic_list.h"
+#include "mirac_dds_log.h"
+
+LOG_MODULE_REGISTER(app, LOG_LEVEL_INF);
+
+// Filled by the main thread, drained by the DDS thread at the talker deadline
+static PublishQueue<std_msgs_msg_String, 2> talker_queue;
+
+static void on_chatter(const std_msgs_msg_String *msg, void *user)
+{
+    ARG_UNUSED(user);
+    // Runs for every sample, keep a fast chatter from flooding the console
+    DDS_HOT_LOG_INF("I heard: %s", msg->data);
+}
 
 int main(void)
 {
     MiracDDS dds_client;
 
+    dds_client.subscribe<ChatterSub>(on_chatter);
+    dds_client.advertise<TalkerPub>(talker_queue);
+
     // Initialize and start MiracDDS thread
     if (!dds_client.startThread())
     {
@@ -30,7 +48,13 @@ int main(void)
 
     while (1)
     {
-        // printk("Hello from main thread\n");
-        k_sleep(K_MSEC(1000));
+        // Never blocks, a full queue just drops this sample
+        std_msgs_msg_String *msg = talker_queue.claim();
+        if (msg)
+        {
+            MiracDDS::updateTopic(msg, "Hello from Zephyr!");
+            talker_queue.commit();
+        }
+        k_sleep(K_MSEC(DDS_DELAY_TALKER_TOPIC_MS));
     };
 }